@@ -153,7 +153,7 @@ class Env(gym.Env):
             self.northbound_interface_client.connect()
         else:
             policy = self.adapter.get_policy(self.last_action) # calling this function updates the timestamp
-            self.northbound_interface_client.send(policy) #send network policy to network gym server
+            self.northbound_interface_client.send(policy, agent=self.northbound_interface_client.agent) #send network policy to network gym server, to the agent group of the last measurement
 
         network_stats = self.northbound_interface_client.recv()#first measurement
 
@@ -214,14 +214,14 @@ class Env(gym.Env):
         if not self.enable_rl_agent or len(action) == 0:
             #empty action
             policy = self.adapter.get_policy(np.array([]))#send empty action to network gym server
-            self.northbound_interface_client.send(policy) #send network policy to network gym server
+            self.northbound_interface_client.send(policy, agent=self.northbound_interface_client.agent) #send network policy to network gym server, to the agent group of the last measurement
         else:
             # TODO: we need to have the same action format... e.g., [0, 1]
             if (action.shape != self.adapter.get_action_space().shape):
                 sys.exit("[Error]: The shape of the action space and the action is not the same!")
             self.last_action = action
             policy = self.adapter.get_policy(action)
-            self.northbound_interface_client.send(policy) #send network policy to network gym server
+            self.northbound_interface_client.send(policy, agent=self.northbound_interface_client.agent) #send network policy to network gym server, to the agent group of the last measurement
 
         #2.) Get measurements from gamsim and obs and reward
         network_stats = self.northbound_interface_client.recv()
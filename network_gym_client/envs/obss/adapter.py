@@ -110,8 +110,8 @@ class Adapter(network_gym_client.adapter.Adapter):
             if row['source'] == 'Obss' and row['name'] == 'Cpp2Py::RxPowerDbmMatrix':
                 for id, value in zip(ids, values):
                     # print("id=", id)
-                    rxNum = id >> 5
-                    txId = id & 0x1f
+                    rxNum = id >> 32
+                    txId = id & 0xffffffff
                     # print("rxId=", rxNum)
                     # print("txId=", txId)
                     rxPowerDbm[rxNum][txId] = value
@@ -0,0 +1,90 @@
+#Copyright(C) 2024 Intel Corporation
+#SPDX-License-Identifier: Apache-2.0
+#File : measurement_reader.py
+
+import json
+import numpy as np
+
+class MeasurementReader:
+    """
+    Reader of the measurement records written by the ns-3 MeasurementRecorder ("record_path" in the env-configure.json).
+    The file is memory-mapped, the id and double value columns are numpy views of the file without a copy.
+    """
+    MAGIC = b"NGYMREC\0"
+    SCHEMA = 1
+    STEP = 2
+    ACTION = 3
+    DOUBLE = 0
+
+    def __init__(self, path):
+        """Open the record file.
+
+        Args:
+            path (str): the record file
+        """
+        self.data = np.memmap(path, dtype=np.uint8, mode='r')
+        if bytes(self.data[:8]) != self.MAGIC:
+            raise ValueError(path + " is not a measurement record.")
+        self.version = int(self.data[8:12].view(np.uint32)[0])
+        self.schema = {} # schema_id -> (source, name)
+
+    def _u64(self, offset):
+        return int(self.data[offset:offset+8].view(np.uint64)[0])
+
+    def records(self):
+        """Iterate over the records in the file order.
+
+        Returns:
+            iterator: ("step", step, ts, network_stats) with the network stats in the layout of the json encoding,
+                or ("action", steps, ts, action_list)
+        """
+        offset = 16
+        while offset + 8 <= len(self.data):
+            record_type, size = self.data[offset:offset+8].view(np.uint32)
+            offset += 8
+            payload = offset
+            if record_type == self.SCHEMA:
+                schema_id, = self.data[payload:payload+4].view(np.uint32)
+                source_size, name_size = self.data[payload+4:payload+8].view(np.uint16)
+                source = bytes(self.data[payload+8:payload+8+source_size]).decode()
+                name = bytes(self.data[payload+8+source_size:payload+8+source_size+name_size]).decode()
+                self.schema[int(schema_id)] = (source, name)
+            elif record_type == self.STEP:
+                step = self._u64(payload)
+                ts = float(self.data[payload+8:payload+16].view(np.float64)[0])
+                columns = int(self.data[payload+16:payload+20].view(np.uint32)[0])
+                pos = payload + 24
+                network_stats = []
+                for _ in range(columns):
+                    schema_id, value_type = self.data[pos:pos+8].view(np.uint32)
+                    column_ts = self._u64(pos+8)
+                    n = self._u64(pos+16)
+                    pos += 24
+                    ids = self.data[pos:pos+8*n].view(np.uint64)
+                    pos += 8*n
+                    if value_type == self.DOUBLE:
+                        values = self.data[pos:pos+8*n].view(np.float64)
+                        pos += 8*n
+                    else:
+                        text_size = self._u64(pos)
+                        values = json.loads(bytes(self.data[pos+8:pos+8+text_size]))
+                        pos += 8 + (text_size + 7) // 8 * 8
+                    source, name = self.schema[int(schema_id)]
+                    network_stats.append({"id": ids, "name": name, "source": source, "ts": column_ts, "value": values})
+                yield ("step", step, ts, network_stats)
+            elif record_type == self.ACTION:
+                steps = self._u64(payload)
+                ts = float(self.data[payload+8:payload+16].view(np.float64)[0])
+                text_size = self._u64(payload+16)
+                yield ("action", steps, ts, json.loads(bytes(self.data[payload+24:payload+24+text_size])))
+            offset = payload + int(size)
+
+    def steps(self):
+        """Iterate over the step records only.
+
+        Returns:
+            iterator: (step, ts, network_stats)
+        """
+        for record in self.records():
+            if record[0] == "step":
+                yield record[1:]
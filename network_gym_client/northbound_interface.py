@@ -8,6 +8,7 @@ import threading
 import time
 from random import randint, random
 import json
+import numpy as np
 import pandas as pd
 
 class NorthBoundClient():
@@ -26,6 +27,9 @@ class NorthBoundClient():
         """
         self.identity = u'%s-%d' % (config_json["session_name"], id)
         self.config_json=config_json
+        self.schema = {} # schema_id -> (source, name) for binary encoded network stats
+        self.delta_values = {} # (source, name) -> (ids, {id: index}, values) of the metrics the env reports on change
+        self.agent = None # agent group of the last measurement, set when the env runs with "agent_groups"
         self.socket = None
         self.context = zmq.Context()
         self.context.setsockopt(zmq.LINGER, 10000)
@@ -49,15 +53,22 @@ class NorthBoundClient():
         self.socket.send(json.dumps(self.config_json["env_config"], indent=2).encode('utf-8'))#send start simulation request
 
     #send action to network gym server
-    def send (self, policy):
+    def send (self, policy, agent=None, action_steps=None):
         """Send the Policy to the server and environment.
 
         Args:
             policy (json): network policy
+            agent (str): agent group of the policy, only used when the env runs with "agent_groups"
+            action_steps (list): one policy per step until the next measurement, only used when the env runs with
+                "steps_per_exchange". The first one replaces the policy. Without it, the policy is held.
         """
         action_json = {}
         action_json["type"] = "env-action"
+        if agent is not None:
+            action_json["agent"] = agent
         action_json["action_list"] = policy
+        if action_steps is not None:
+            action_json["action_steps"] = action_steps
         #print(action_json)
         json_str = json.dumps(action_json, indent=2)
         #print(identity +" Send: "+ json_str)
@@ -82,7 +93,8 @@ class NorthBoundClient():
                 raise IOError("Cannot connect to the server! Check the configure parameters in common_config.json. Make sure the server_ip and server_port is correct and you can ping server_ip.")
             else:
                 raise IOError("Cannot connect to the server! Check the configure parameters in common_config.json. Make sure the port forwarding to external server is up.")
-        reply = self.socket.recv()
+        frames = self.socket.recv_multipart()
+        reply = frames[0]
         relay_json = json.loads(reply)
 
         #print(relay_json)        
@@ -103,6 +115,11 @@ class NorthBoundClient():
         #    return None
 
         elif  relay_json["type"] == "env-measurement":
+            # agent group of this measurement in the multi-agent mode, None otherwise
+            self.agent = relay_json.get("agent")
+            if "encoding" in relay_json:
+                relay_json["network_stats"] = self.decode_network_stats(relay_json, frames[1])
+            self.fill_delta(relay_json["network_stats"])
             return self.process_measurement(relay_json)
 
         elif relay_json["type"] == "env-error":
@@ -119,6 +136,70 @@ class NorthBoundClient():
             self.context.term()
             sys.exit(self.identity +" Simulation Stopped with ***[Error]***! MSG:"+ reply.decode())
      
+    def decode_network_stats (self, header_json, payload):
+        """Decode the binary network stats frame (msgpack or cbor).
+
+        Args:
+            header_json (json): the measurement header, carries the encoding and the new schema entries
+            payload (bytes): the encoded [schema_id, ts, id, value] columns
+
+        Returns:
+            list: the network stats in the same layout as the json encoding
+        """
+        for item in header_json.get("schema", []):
+            self.schema[item["schema_id"]] = (item["source"], item["name"])
+
+        if header_json["encoding"] == "msgpack":
+            import msgpack
+            columns = msgpack.unpackb(payload)
+        elif header_json["encoding"] == "cbor":
+            import cbor2
+            columns = cbor2.loads(payload)
+        else:
+            sys.exit(self.identity +" [Error] : Unkown network stats encoding: " + str(header_json["encoding"]))
+
+        network_stats = []
+        for column in columns:
+            schema_id, ts, ids, values = column[:4]
+            source, name = self.schema[schema_id]
+            if isinstance(values, bytes):
+                # packed little-endian float64 array
+                values = np.frombuffer(values, dtype='<f8').tolist()
+            entry = {"id": ids, "name": name, "source": source, "ts": ts, "value": values}
+            if len(column) > 4:
+                entry["delta"] = column[4]
+            network_stats.append(entry)
+        return network_stats
+
+    def fill_delta (self, network_stats):
+        """Fill in the values omitted by the on-change reporting ("delta_network_stats" of the env).
+
+        An entry with "delta": false is a keyframe and replaces the known values of its metric. An entry with
+        "delta": true only carries the changed ids, the other ids keep their last value. The ids keep the order of
+        the keyframe, the values of a delta are patched in place and new ids are added at the end. The entries are
+        updated in place and the "delta" flag is removed.
+
+        Args:
+            network_stats (list): the network stats entries, in the order of the steps
+        """
+        for entry in network_stats:
+            if "delta" not in entry:
+                continue
+            key = (entry["source"], entry["name"])
+            if not entry.pop("delta") or key not in self.delta_values:
+                # keyframe: the ids, their index and the values of the metric
+                self.delta_values[key] = ([], {}, [])
+            ids, index, values = self.delta_values[key]
+            for i, value in zip(entry["id"], entry["value"]):
+                if i in index:
+                    values[index[i]] = value
+                else:
+                    index[i] = len(ids)
+                    ids.append(i)
+                    values.append(value)
+            entry["id"] = list(ids)
+            entry["value"] = list(values)
+
     def process_measurement (self, reply_json):
         """Process the measurement.
 
@@ -0,0 +1,85 @@
+#Copyright(C) 2024 Intel Corporation
+#SPDX-License-Identifier: Apache-2.0
+#File : test_northbound_interface.py
+#Run : python3 network_gym_client/test_northbound_interface.py
+
+import importlib.util
+import os
+import sys
+import types
+import unittest
+
+# zmq, numpy and pandas are only used by the socket and the dataframe paths, stub them if they are not installed.
+for module_name in ["zmq", "numpy", "pandas"]:
+    try:
+        __import__(module_name)
+    except ImportError:
+        sys.modules[module_name] = types.ModuleType(module_name)
+
+# load the module without the package, which imports the gym environment.
+spec = importlib.util.spec_from_file_location("northbound_interface", os.path.join(os.path.dirname(os.path.abspath(__file__)), "northbound_interface.py"))
+northbound_interface = importlib.util.module_from_spec(spec)
+spec.loader.exec_module(northbound_interface)
+
+def make_entry(ids, values, delta, name="Cpp2Py::X"):
+    return {"source": "Test", "name": name, "ts": 0, "id": ids, "value": values, "delta": delta}
+
+class FillDeltaTest(unittest.TestCase):
+    """Test the on-change reporting of NorthBoundClient.fill_delta."""
+
+    def setUp(self):
+        # fill_delta only uses the delta state, the socket is not connected.
+        self.client = northbound_interface.NorthBoundClient.__new__(northbound_interface.NorthBoundClient)
+        self.client.delta_values = {}
+
+    def test_keyframe_order_is_kept(self):
+        keyframe = make_entry([3, 1, 2], [30.0, 10.0, 20.0], False)
+        self.client.fill_delta([keyframe])
+        self.assertEqual(keyframe["id"], [3, 1, 2])
+        self.assertEqual(keyframe["value"], [30.0, 10.0, 20.0])
+        self.assertNotIn("delta", keyframe)
+
+        delta = make_entry([2], [21.0], True)
+        self.client.fill_delta([delta])
+        self.assertEqual(delta["id"], [3, 1, 2])
+        self.assertEqual(delta["value"], [30.0, 10.0, 21.0])
+
+    def test_new_ids_are_appended(self):
+        self.client.fill_delta([make_entry([5, 7], [0.5, 0.7], False)])
+        delta = make_entry([6, 5], [0.6, 0.55], True)
+        self.client.fill_delta([delta])
+        self.assertEqual(delta["id"], [5, 7, 6])
+        self.assertEqual(delta["value"], [0.55, 0.7, 0.6])
+
+    def test_keyframe_replaces_known_values(self):
+        self.client.fill_delta([make_entry([1, 2], [1.0, 2.0], False)])
+        keyframe = make_entry([2], [2.5], False)
+        self.client.fill_delta([keyframe])
+        self.assertEqual(keyframe["id"], [2])
+        self.assertEqual(keyframe["value"], [2.5])
+
+    def test_entries_of_previous_steps_are_not_changed(self):
+        # a batch of steps, every entry holds the values of its own step
+        keyframe = make_entry([1, 2], [1.0, 2.0], False)
+        delta = make_entry([1], [1.5], True)
+        self.client.fill_delta([keyframe, delta])
+        self.assertEqual(keyframe["value"], [1.0, 2.0])
+        self.assertEqual(delta["value"], [1.5, 2.0])
+
+    def test_delta_before_keyframe_and_plain_entries(self):
+        plain = {"source": "Test", "name": "Cpp2Py::Y", "ts": 0, "id": [2, 1], "value": [2, 1]}
+        delta = make_entry([4], [4.0], True)
+        self.client.fill_delta([plain, delta])
+        self.assertEqual(plain["id"], [2, 1])
+        self.assertEqual(delta["id"], [4])
+        self.assertEqual(delta["value"], [4.0])
+
+    def test_metrics_are_independent(self):
+        self.client.fill_delta([make_entry([1], [1.0], False, "Cpp2Py::A"), make_entry([1], [9.0], False, "Cpp2Py::B")])
+        delta = make_entry([2], [2.0], True, "Cpp2Py::A")
+        self.client.fill_delta([delta])
+        self.assertEqual(delta["id"], [1, 2])
+        self.assertEqual(delta["value"], [1.0, 2.0])
+
+if __name__ == '__main__':
+    unittest.main()
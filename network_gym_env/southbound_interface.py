@@ -20,5 +20,22 @@ def southbound_connect(identity, config_json, context):
     sb_socket.plain_password = bytes(config_json["session_key"], 'utf-8')
     
     sb_socket.identity = identity.encode('utf-8')
-    sb_socket.connect('tcp://localhost:'+str(config_json["env_port"]))
-    return sb_socket
\ No newline at end of file
+    sb_socket.connect(southbound_endpoint(config_json))
+    return sb_socket
+
+def southbound_endpoint(config_json):
+    """Get the server endpoint of the southbound interface, the ns-3 simulator uses the same rule.
+
+    Args:
+        config_json (json): configuration file for southbound interface
+
+    Returns:
+        str: tcp://localhost:env_port, or ipc://env_ipc_path if env_transport is "ipc"
+    """
+    transport = config_json.get("env_transport", "tcp")
+    if transport == "tcp":
+        return 'tcp://localhost:'+str(config_json["env_port"])
+    elif transport == "ipc":
+        # the server binds the same path, see "network_gym_sim_ipc_path" in the server config.
+        return 'ipc://'+config_json.get("env_ipc_path", "/tmp/network_gym_sim_"+str(config_json["env_port"]))
+    raise ValueError("Unknown env_transport " + str(transport) + ", use tcp or ipc.")
\ No newline at end of file
@@ -0,0 +1,390 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+// Microbenchmarks of the networkgym measurement and action paths, built if Google Benchmark is
+// found. The measurements are synthetic: N nodes x K metrics of one source. The southbound
+// interface connects to a loopback ZMQ peer in the same process, which replies to every
+// measurement with an empty action, such that a DataProcessor step is a full round trip.
+//
+// Run from the build output directory, e.g.:
+//   ./networkgym-benchmark --benchmark_filter=Step --benchmark_counters_tabular=true
+
+#include "ns3/data-processor.h"
+#include "ns3/measurement-aggregator.h"
+#include "ns3/simulator.h"
+#include "ns3/southbound-interface.h"
+
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <unistd.h>
+#include <zmq.h>
+
+using namespace ns3;
+
+namespace
+{
+
+/// The source of the synthetic measurements
+const std::string BENCH_SOURCE = "Bench";
+/// The largest number of metrics of a benchmark, all of them are subscribed
+const uint32_t MAX_METRICS = 16;
+
+/// \return the name of metric i
+std::string
+MetricName(uint32_t i)
+{
+    return "Cpp2Py::Metric" + std::to_string(i);
+}
+
+/**
+ * A ZMQ ROUTER in a background thread, standing in for the networkgym server. It receives the
+ * measurements of the southbound interfaces and replies with an empty action.
+ */
+class LoopbackPeer
+{
+  public:
+    LoopbackPeer()
+    {
+        m_context = zmq_ctx_new();
+        m_socket = zmq_socket(m_context, ZMQ_ROUTER);
+        int one = 1;
+        // The southbound interface uses PLAIN, without a ZAP handler every user is accepted
+        zmq_setsockopt(m_socket, ZMQ_PLAIN_SERVER, &one, sizeof one);
+        // Every benchmark connects a new socket with the same identity
+        zmq_setsockopt(m_socket, ZMQ_ROUTER_HANDOVER, &one, sizeof one);
+        zmq_bind(m_socket, "tcp://127.0.0.1:*");
+        char endpoint[256];
+        size_t size = sizeof endpoint;
+        zmq_getsockopt(m_socket, ZMQ_LAST_ENDPOINT, endpoint, &size);
+        m_port = std::atoi(std::strrchr(endpoint, ':') + 1);
+        m_thread = std::thread(&LoopbackPeer::Run, this);
+    }
+
+    ~LoopbackPeer()
+    {
+        m_running = false;
+        m_thread.join();
+        zmq_close(m_socket);
+        zmq_ctx_destroy(m_context);
+    }
+
+    /// \return the TCP port of the peer
+    int GetPort() const
+    {
+        return m_port;
+    }
+
+  private:
+    void Run()
+    {
+        const std::string action = R"({"type":"env-action","action_list":[]})";
+        std::vector<zmq_msg_t> frames;
+        while (m_running)
+        {
+            zmq_pollitem_t items[] = {{m_socket, 0, ZMQ_POLLIN, 0}};
+            if (zmq_poll(items, 1, 100) <= 0)
+            {
+                continue;
+            }
+            // routing ID, client identity, report header and the optional binary payload
+            frames.clear();
+            int more = 1;
+            while (more)
+            {
+                frames.emplace_back();
+                zmq_msg_init(&frames.back());
+                zmq_msg_recv(&frames.back(), m_socket, 0);
+                more = zmq_msg_more(&frames.back());
+            }
+            if (frames.size() >= 3)
+            {
+                zmq_send(m_socket, zmq_msg_data(&frames[0]), zmq_msg_size(&frames[0]), ZMQ_SNDMORE);
+                zmq_send(m_socket, zmq_msg_data(&frames[1]), zmq_msg_size(&frames[1]), ZMQ_SNDMORE);
+                zmq_send(m_socket, action.data(), action.size(), 0);
+            }
+            for (auto& frame : frames)
+            {
+                zmq_msg_close(&frame);
+            }
+        }
+    }
+
+    void* m_context;
+    void* m_socket;
+    int m_port;
+    std::atomic<bool> m_running{true};
+    std::thread m_thread;
+};
+
+/**
+ * Fill a NetworkStats with one column per metric, one value per node.
+ * \param stats the network stats
+ * \param ids the node IDs
+ * \param values the values of a column
+ * \param metrics the number of metrics
+ */
+void
+FillStats(Ptr<NetworkStats> stats,
+          const std::vector<uint64_t>& ids,
+          const std::vector<double>& values,
+          uint32_t metrics)
+{
+    for (uint32_t k = 0; k < metrics; ++k)
+    {
+        stats->Append(MetricName(k), ids, values);
+    }
+}
+
+/// \return the node IDs 0 to nodes - 1 in a random order, the order of a scenario is not sorted
+std::vector<uint64_t>
+ShuffledIds(uint32_t nodes)
+{
+    std::vector<uint64_t> ids(nodes);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(1));
+    return ids;
+}
+
+void
+SetCounters(benchmark::State& state, uint32_t nodes, uint32_t metrics)
+{
+    state.SetItemsProcessed(state.iterations() * nodes * metrics);
+    state.counters["nodes"] = nodes;
+    state.counters["metrics"] = metrics;
+}
+
+/// NetworkStats::Append of K columns of N values, i.e., the measurement generation
+void
+BM_NetworkStatsAppend(benchmark::State& state)
+{
+    uint32_t nodes = state.range(0);
+    uint32_t metrics = state.range(1);
+    std::vector<uint64_t> ids = ShuffledIds(nodes);
+    std::vector<double> values(nodes, 1.5);
+    Ptr<NetworkStats> stats = CreateObject<NetworkStats>(BENCH_SOURCE);
+    uint64_t ts = 0;
+    for (auto _ : state)
+    {
+        stats->Reset(++ts);
+        FillStats(stats, ids, values, metrics);
+        benchmark::DoNotOptimize(stats->GetMetrics().data());
+    }
+    SetCounters(state, nodes, metrics);
+}
+
+/// MeasurementAggregator append and Flush, i.e., the batch merge of a step
+void
+BM_MeasurementAggregatorFlush(benchmark::State& state)
+{
+    uint32_t nodes = state.range(0);
+    uint32_t metrics = state.range(1);
+    std::vector<uint64_t> ids = ShuffledIds(nodes);
+    std::vector<double> values(nodes, 1.5);
+    MeasurementAggregator aggregator;
+    std::vector<uint32_t> keys;
+    for (uint32_t k = 0; k < metrics; ++k)
+    {
+        keys.push_back(aggregator.Intern(BENCH_SOURCE, MetricName(k)));
+    }
+    uint64_t ts = 0;
+    for (auto _ : state)
+    {
+        ++ts;
+        for (uint32_t key : keys)
+        {
+            aggregator.Append(key, ts, ids, values);
+        }
+        json networkStats = aggregator.Flush();
+        benchmark::DoNotOptimize(networkStats);
+    }
+    SetCounters(state, nodes, metrics);
+}
+
+/// SouthboundInterface serialization and send of the merged network stats
+void
+BM_SouthboundSend(benchmark::State& state)
+{
+    uint32_t nodes = state.range(0);
+    static const char* encodings[] = {"json", "msgpack", "cbor"};
+    const char* encoding = encodings[state.range(1)];
+    std::vector<uint64_t> ids = ShuffledIds(nodes);
+    std::vector<double> values(nodes, 1.5);
+    MeasurementAggregator aggregator;
+    aggregator.Append(aggregator.Intern(BENCH_SOURCE, MetricName(0)), 1, ids, values);
+    json networkStats = aggregator.Flush();
+    json workloadStats = json::object();
+
+    Ptr<SouthboundInterface> southbound = CreateObject<SouthboundInterface>();
+    southbound->SetAttribute("MeasurementEncoding", StringValue(encoding));
+    southbound->Connect();
+    for (auto _ : state)
+    {
+        // the stats are moved into the report, the copy stands in for the merge of the step
+        state.PauseTiming();
+        json stepStats = networkStats;
+        json stepWorkloadStats = workloadStats;
+        state.ResumeTiming();
+        southbound->SendMeasurementJson(stepStats, stepWorkloadStats);
+    }
+    southbound->Dispose();
+    state.SetItemsProcessed(state.iterations() * nodes);
+    state.counters["nodes"] = nodes;
+    state.SetLabel(encoding);
+}
+
+/// SouthboundInterface binary encoding of the merged columns, without the network stats json
+void
+BM_SouthboundSendColumns(benchmark::State& state)
+{
+    uint32_t nodes = state.range(0);
+    static const char* encodings[] = {"json", "msgpack", "cbor"};
+    const char* encoding = encodings[state.range(1)];
+    std::vector<uint64_t> ids = ShuffledIds(nodes);
+    std::vector<double> values(nodes, 1.5);
+    MeasurementAggregator aggregator;
+    uint32_t key = aggregator.Intern(BENCH_SOURCE, MetricName(0));
+
+    Ptr<SouthboundInterface> southbound = CreateObject<SouthboundInterface>();
+    southbound->SetAttribute("MeasurementEncoding", StringValue(encoding));
+    southbound->Connect();
+    for (auto _ : state)
+    {
+        aggregator.Append(key, 1, ids, values);
+        json workloadStats = json::object();
+        southbound->SendMeasurementColumns(aggregator, workloadStats);
+        aggregator.Clear();
+    }
+    southbound->Dispose();
+    state.SetItemsProcessed(state.iterations() * nodes);
+    state.counters["nodes"] = nodes;
+    state.SetLabel(encoding);
+}
+
+/// DataProcessor::AppendMeasurement and the exchange of a step, including the action round trip
+void
+BM_DataProcessorStep(benchmark::State& state)
+{
+    uint32_t nodes = state.range(0);
+    uint32_t metrics = state.range(1);
+    std::vector<uint64_t> ids = ShuffledIds(nodes);
+    std::vector<double> values(nodes, 1.5);
+    Ptr<DataProcessor> dataProcessor = CreateObject<DataProcessor>();
+    dataProcessor->StartMeasurement();
+    Ptr<NetworkStats> stats = CreateObject<NetworkStats>(BENCH_SOURCE);
+    for (auto _ : state)
+    {
+        stats->Reset(Simulator::Now().GetMilliSeconds());
+        FillStats(stats, ids, values, metrics);
+        dataProcessor->AppendMeasurement(stats);
+        // The exchange is scheduled 1 ns later, and waits for the action of the peer
+        Simulator::Run();
+    }
+    dataProcessor->Dispose();
+    Simulator::Destroy();
+    SetCounters(state, nodes, metrics);
+}
+
+/// 10 to 10,000 nodes times 1 or 8 metrics
+void
+NodesAndMetrics(benchmark::internal::Benchmark* benchmark)
+{
+    for (int64_t nodes = 10; nodes <= 10000; nodes *= 10)
+    {
+        for (int64_t metrics : {1, 8})
+        {
+            benchmark->Args({nodes, metrics});
+        }
+    }
+}
+
+/// 10 to 10,000 nodes times the json, msgpack and cbor encodings
+void
+NodesAndEncodings(benchmark::internal::Benchmark* benchmark)
+{
+    for (int64_t nodes = 10; nodes <= 10000; nodes *= 10)
+    {
+        for (int64_t encoding : {0, 1, 2})
+        {
+            benchmark->Args({nodes, encoding});
+        }
+    }
+}
+
+/// 10 to 10,000 nodes times the msgpack and cbor encodings
+void
+NodesAndBinaryEncodings(benchmark::internal::Benchmark* benchmark)
+{
+    for (int64_t nodes = 10; nodes <= 10000; nodes *= 10)
+    {
+        for (int64_t encoding : {1, 2})
+        {
+            benchmark->Args({nodes, encoding});
+        }
+    }
+}
+
+/**
+ * Write the gym-configure.json and env-configure.json of the loopback peer to a temporary
+ * directory and enter it, the southbound interface and the data processor read them from the
+ * current directory.
+ * \param port the port of the peer
+ */
+void
+EnterConfigDirectory(int port)
+{
+    auto dir = std::filesystem::temp_directory_path() /
+               ("networkgym-benchmark-" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir);
+    std::filesystem::current_path(dir);
+
+    json gymConfig;
+    gymConfig["env_identity"] = "networkgym-benchmark";
+    gymConfig["client_identity"] = "networkgym-benchmark-client";
+    gymConfig["session_name"] = "benchmark";
+    gymConfig["session_key"] = "benchmark";
+    gymConfig["env_port"] = port;
+    std::ofstream("gym-configure.json") << gymConfig;
+
+    json envConfig;
+    envConfig["steps_per_episode"] = 1ULL << 40;
+    envConfig["episodes_per_session"] = 1;
+    envConfig["subscribed_network_stats"] = json::array();
+    for (uint32_t k = 0; k < MAX_METRICS; ++k)
+    {
+        envConfig["subscribed_network_stats"].push_back(BENCH_SOURCE + "::" + MetricName(k));
+    }
+    std::ofstream("env-configure.json") << envConfig;
+}
+
+} // namespace
+
+BENCHMARK(BM_NetworkStatsAppend)->Apply(NodesAndMetrics);
+BENCHMARK(BM_MeasurementAggregatorFlush)->Apply(NodesAndMetrics);
+BENCHMARK(BM_SouthboundSend)->Apply(NodesAndEncodings);
+BENCHMARK(BM_SouthboundSendColumns)->Apply(NodesAndBinaryEncodings);
+BENCHMARK(BM_DataProcessorStep)->Apply(NodesAndMetrics);
+
+int
+main(int argc, char** argv)
+{
+    LoopbackPeer peer;
+    EnterConfigDirectory(peer.GetPort());
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,282 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#include "networkgym-node-config.h"
+
+#include "ns3/fatal-error.h"
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+
+namespace ns3
+{
+
+namespace
+{
+
+/// Record of the binary form
+struct BinaryRecord
+{
+    uint32_t nodeId;         //!< node ID
+    uint8_t trafficType;     //!< NetworkGymTrafficType
+    uint8_t padding[3];      //!< zero
+    float ccaSensitivityDbm; //!< CCA sensitivity
+    float txPowerDbm;        //!< TX power
+    uint16_t channelWidth;   //!< channel width, in MHz
+    uint16_t channelNumber;  //!< channel number
+};
+
+static_assert(sizeof(BinaryRecord) == 20, "unexpected padding in the binary record");
+
+/**
+ * \param field the field
+ * \return the field without the surrounding blanks and quotes
+ */
+std::string_view
+Trim(std::string_view field)
+{
+    const char* blanks = " \t\r\"";
+    size_t begin = field.find_first_not_of(blanks);
+    if (begin == std::string_view::npos)
+    {
+        return {};
+    }
+    return field.substr(begin, field.find_last_not_of(blanks) - begin + 1);
+}
+
+/**
+ * Parse a number, abort if the field is not a number.
+ * \param field the field
+ * \param line the line, for the error message
+ * \return the number
+ */
+template <typename T>
+T
+ParseNumber(std::string_view field, std::string_view line)
+{
+    field = Trim(field);
+    T value{};
+    bool valid;
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        // Floating point std::from_chars needs a recent standard library, use strtod on a copy
+        char buffer[64];
+        valid = !field.empty() && field.size() < sizeof(buffer);
+        if (valid)
+        {
+            std::memcpy(buffer, field.data(), field.size());
+            buffer[field.size()] = '\0';
+            char* end;
+            value = std::strtod(buffer, &end);
+            valid = end == buffer + field.size();
+        }
+    }
+    else
+    {
+        auto [end, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+        valid = ec == std::errc() && end == field.data() + field.size();
+    }
+    if (!valid)
+    {
+        NS_FATAL_ERROR("Invalid number '" << field << "' in configuration line: " << line);
+    }
+    return value;
+}
+
+/**
+ * \param configs the configurations, indexed by node ID
+ * \param nodeId the node ID
+ * \return the configuration of the node, the vector is grown if needed
+ */
+NetworkGymNodeConfig&
+GetOrAdd(std::vector<NetworkGymNodeConfig>& configs, uint32_t nodeId)
+{
+    if (nodeId >= configs.size())
+    {
+        configs.resize(nodeId + 1);
+    }
+    return configs[nodeId];
+}
+
+} // namespace
+
+std::vector<NetworkGymNodeConfig>
+NetworkGymNodeConfigLoader::Load(const std::string& filename)
+{
+    std::ifstream configFile(filename, std::ios::binary);
+    if (!configFile)
+    {
+        std::cerr << "Error opening configuration file: " << filename << std::endl;
+        return {};
+    }
+    std::string data((std::istreambuf_iterator<char>(configFile)), std::istreambuf_iterator<char>());
+    if (data.size() >= sizeof(BINARY_MAGIC) &&
+        std::memcmp(data.data(), BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0)
+    {
+        return ParseBinary(data);
+    }
+    return ParseText(data);
+}
+
+std::vector<NetworkGymNodeConfig>
+NetworkGymNodeConfigLoader::ParseText(std::string_view text)
+{
+    std::vector<NetworkGymNodeConfig> configs;
+    while (!text.empty())
+    {
+        size_t lineEnd = text.find('\n');
+        std::string_view line = text.substr(0, lineEnd);
+        text = lineEnd == std::string_view::npos ? std::string_view() : text.substr(lineEnd + 1);
+
+        if (line.empty() || line.front() == '#')
+        {
+            continue;
+        }
+        size_t delimiterPos = line.find(':');
+        if (delimiterPos == std::string_view::npos)
+        {
+            continue;
+        }
+
+        std::string_view fields[5];
+        std::string_view rest = line.substr(delimiterPos + 1);
+        uint32_t nFields = 0;
+        while (nFields < 5)
+        {
+            size_t comma = rest.find(',');
+            fields[nFields++] = rest.substr(0, comma);
+            if (comma == std::string_view::npos)
+            {
+                break;
+            }
+            rest = rest.substr(comma + 1);
+        }
+        if (nFields < 5)
+        {
+            NS_FATAL_ERROR("Expected 5 fields in configuration line: " << line);
+        }
+
+        uint32_t nodeId = ParseNumber<uint32_t>(line.substr(0, delimiterPos), line);
+        NetworkGymNodeConfig& config = GetOrAdd(configs, nodeId);
+        config.configured = true;
+        config.trafficType = ParseTrafficType(Trim(fields[0]));
+        config.ccaSensitivityDbm = ParseNumber<double>(fields[1], line);
+        config.txPowerDbm = ParseNumber<double>(fields[2], line);
+        config.channelWidth = ParseNumber<uint16_t>(fields[3], line);
+        config.channelNumber = ParseNumber<uint16_t>(fields[4], line);
+    }
+    return configs;
+}
+
+std::vector<NetworkGymNodeConfig>
+NetworkGymNodeConfigLoader::ParseBinary(std::string_view data)
+{
+    uint32_t count = 0;
+    if (data.size() < sizeof(BINARY_MAGIC) + sizeof(count))
+    {
+        NS_FATAL_ERROR("Truncated binary configuration");
+    }
+    std::memcpy(&count, data.data() + sizeof(BINARY_MAGIC), sizeof(count));
+    const char* records = data.data() + sizeof(BINARY_MAGIC) + sizeof(count);
+    if (data.size() != sizeof(BINARY_MAGIC) + sizeof(count) + count * sizeof(BinaryRecord))
+    {
+        NS_FATAL_ERROR("The size of the binary configuration does not match its " << count
+                                                                                   << " records");
+    }
+
+    std::vector<NetworkGymNodeConfig> configs;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        BinaryRecord record;
+        std::memcpy(&record, records + i * sizeof(BinaryRecord), sizeof(BinaryRecord));
+        if (record.trafficType > NETWORKGYM_TRAFFIC_BURSTY)
+        {
+            NS_FATAL_ERROR("Unknown traffic type " << +record.trafficType << " of node "
+                                                   << record.nodeId);
+        }
+        NetworkGymNodeConfig& config = GetOrAdd(configs, record.nodeId);
+        config.configured = true;
+        config.trafficType = static_cast<NetworkGymTrafficType>(record.trafficType);
+        config.ccaSensitivityDbm = record.ccaSensitivityDbm;
+        config.txPowerDbm = record.txPowerDbm;
+        config.channelWidth = record.channelWidth;
+        config.channelNumber = record.channelNumber;
+    }
+    return configs;
+}
+
+void
+NetworkGymNodeConfigLoader::SaveBinary(const std::string& filename,
+                                       const std::vector<NetworkGymNodeConfig>& configs)
+{
+    std::vector<BinaryRecord> records;
+    for (uint32_t nodeId = 0; nodeId < configs.size(); nodeId++)
+    {
+        const NetworkGymNodeConfig& config = configs[nodeId];
+        if (!config.configured)
+        {
+            continue;
+        }
+        BinaryRecord record{};
+        record.nodeId = nodeId;
+        record.trafficType = config.trafficType;
+        record.ccaSensitivityDbm = config.ccaSensitivityDbm;
+        record.txPowerDbm = config.txPowerDbm;
+        record.channelWidth = config.channelWidth;
+        record.channelNumber = config.channelNumber;
+        records.push_back(record);
+    }
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        NS_FATAL_ERROR("Cannot open " << filename);
+    }
+    uint32_t count = records.size();
+    file.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(BinaryRecord));
+}
+
+NetworkGymTrafficType
+NetworkGymNodeConfigLoader::ParseTrafficType(std::string_view name)
+{
+    if (name == "none")
+    {
+        return NETWORKGYM_TRAFFIC_NONE;
+    }
+    if (name == "constant")
+    {
+        return NETWORKGYM_TRAFFIC_CONSTANT;
+    }
+    if (name == "bursty")
+    {
+        return NETWORKGYM_TRAFFIC_BURSTY;
+    }
+    NS_FATAL_ERROR("Unknown traffic type '" << name << "'");
+    return NETWORKGYM_TRAFFIC_NONE;
+}
+
+std::ostream&
+operator<<(std::ostream& os, NetworkGymTrafficType type)
+{
+    switch (type)
+    {
+    case NETWORKGYM_TRAFFIC_NONE:
+        return os << "none";
+    case NETWORKGYM_TRAFFIC_CONSTANT:
+        return os << "constant";
+    case NETWORKGYM_TRAFFIC_BURSTY:
+        return os << "bursty";
+    }
+    return os << "unknown";
+}
+
+} // namespace ns3
@@ -0,0 +1,107 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#ifndef NETWORKGYM_NODE_CONFIG_H
+#define NETWORKGYM_NODE_CONFIG_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup networkgym
+ * Traffic generated by a node of the scenario configuration
+ */
+enum NetworkGymTrafficType : uint8_t
+{
+    NETWORKGYM_TRAFFIC_NONE = 0, //!< "none", e.g., an AP
+    NETWORKGYM_TRAFFIC_CONSTANT, //!< "constant", packet socket client with a constant interval
+    NETWORKGYM_TRAFFIC_BURSTY,   //!< "bursty", bursty application
+};
+
+/**
+ * \ingroup networkgym
+ * Configuration of one node of the scenario configuration file
+ */
+struct NetworkGymNodeConfig
+{
+    bool configured{false};                              //!< whether the file has a line for the node
+    NetworkGymTrafficType trafficType{NETWORKGYM_TRAFFIC_NONE}; //!< traffic type
+    double ccaSensitivityDbm{0};                         //!< CCA sensitivity
+    double txPowerDbm{0};                                //!< initial TX power
+    uint16_t channelWidth{0};                            //!< channel width, in MHz
+    uint16_t channelNumber{0};                           //!< channel number
+};
+
+/**
+ * \ingroup networkgym
+ * \brief Loader of the scenario configuration file.
+ *
+ * The text form has one line per node:
+ * "<node id>:<traffic type>,<CCA sensitivity dBm>,<TX power dBm>,<channel width MHz>,<channel>",
+ * lines starting with '#' are skipped. The file is read at once and each line is parsed in place.
+ *
+ * The binary form starts with the 8 bytes of BINARY_MAGIC, followed by the number of records and
+ * the records, see SaveBinary. All fields are in host byte order. The form is detected by the
+ * magic, so both can be passed with --configFile.
+ */
+class NetworkGymNodeConfigLoader
+{
+  public:
+    /// Magic of the binary form
+    static constexpr char BINARY_MAGIC[8] = {'N', 'G', 'Y', 'M', 'C', 'F', 'G', '1'};
+
+    /**
+     * \param filename the text or binary configuration file
+     * \return the configuration of each node, indexed by node ID; empty if the file cannot be
+     * opened
+     */
+    static std::vector<NetworkGymNodeConfig> Load(const std::string& filename);
+
+    /**
+     * \param text the content of a text configuration file
+     * \return the configuration of each node, indexed by node ID
+     */
+    static std::vector<NetworkGymNodeConfig> ParseText(std::string_view text);
+
+    /**
+     * \param data the content of a binary configuration file, starting with BINARY_MAGIC
+     * \return the configuration of each node, indexed by node ID
+     */
+    static std::vector<NetworkGymNodeConfig> ParseBinary(std::string_view data);
+
+    /**
+     * Write the configured nodes in the binary form. Each record is the node ID (uint32_t),
+     * the traffic type (uint8_t), 3 padding bytes, the CCA sensitivity and the TX power (float,
+     * dBm), the channel width (uint16_t, MHz) and the channel number (uint16_t).
+     *
+     * \param filename the output file
+     * \param configs the configuration of each node, indexed by node ID
+     */
+    static void SaveBinary(const std::string& filename,
+                           const std::vector<NetworkGymNodeConfig>& configs);
+
+    /**
+     * \param name "none", "constant" or "bursty"
+     * \return the traffic type
+     */
+    static NetworkGymTrafficType ParseTrafficType(std::string_view name);
+};
+
+/**
+ * \param os the output stream
+ * \param type the traffic type
+ * \return the output stream, with the name of the traffic type
+ */
+std::ostream& operator<<(std::ostream& os, NetworkGymTrafficType type);
+
+} // namespace ns3
+
+#endif /* NETWORKGYM_NODE_CONFIG_H */
@@ -0,0 +1,102 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#include "networkgym-replica-helper.h"
+
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NetworkGymReplicaHelper");
+
+bool
+NetworkGymReplicaHelper::ForkReplicas(int& argc, char* argv[], int& exitCode)
+{
+    const char* option = "--replicaDirs=";
+    std::vector<std::string> dirs;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], option, std::strlen(option)) != 0)
+        {
+            continue;
+        }
+        std::stringstream ss(argv[i] + std::strlen(option));
+        std::string dir;
+        while (std::getline(ss, dir, ','))
+        {
+            if (!dir.empty())
+            {
+                dirs.push_back(dir);
+            }
+        }
+        // Remove the option, the scenario's CommandLine does not know it
+        for (int j = i; j < argc - 1; ++j)
+        {
+            argv[j] = argv[j + 1];
+        }
+        --argc;
+        argv[argc] = nullptr;
+        break;
+    }
+
+    if (dirs.empty())
+    {
+        return false;
+    }
+    return ForkReplicas(dirs, exitCode);
+}
+
+bool
+NetworkGymReplicaHelper::ForkReplicas(const std::vector<std::string>& dirs, int& exitCode)
+{
+    // Flush before the fork, otherwise every child prints the buffered output again
+    std::cout.flush();
+    std::cerr.flush();
+
+    std::vector<pid_t> pids;
+    for (const auto& dir : dirs)
+    {
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            NS_FATAL_ERROR("Cannot fork the replica for " << dir << ": " << std::strerror(errno));
+        }
+        if (pid == 0)
+        {
+            if (chdir(dir.c_str()) != 0)
+            {
+                std::cerr << "Cannot enter the replica directory " << dir << ": "
+                          << std::strerror(errno) << std::endl;
+                _exit(1);
+            }
+            return false;
+        }
+        NS_LOG_INFO("replica " << dir << " started with pid " << pid);
+        pids.push_back(pid);
+    }
+
+    exitCode = 0;
+    for (uint32_t i = 0; i < pids.size(); ++i)
+    {
+        int status = 0;
+        if (waitpid(pids[i], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            std::cout << "replica " << dirs[i] << " failed." << std::endl;
+            ++exitCode;
+        }
+    }
+    return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,55 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#ifndef NETWORKGYM_REPLICA_HELPER_H
+#define NETWORKGYM_REPLICA_HELPER_H
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup networkgym
+ * \brief Run several environment replicas from one ns-3 launch.
+ *
+ * The ns-3 Simulator is a process wide singleton, so the replicas cannot share a process on
+ * different threads. Instead, the scenario forks one child per replica after ns-3 is loaded.
+ * The children share the loaded libraries and the initialized TypeId registry copy-on-write,
+ * and each child runs the scenario in its own working directory. The gym-configure.json and
+ * env-configure.json of a directory carry the ZMQ identities and configuration of that replica.
+ *
+ * The DataProcessor must be created after ForkReplicas returns, such that it reads the
+ * configuration of the replica and opens its own ZMQ context after the fork.
+ */
+class NetworkGymReplicaHelper
+{
+  public:
+    /**
+     * Fork one child per directory listed in "--replicaDirs=dir1,dir2,...". The option is
+     * removed from argv, such that the scenario can parse the remaining arguments.
+     *
+     * \param argc the argument count of main, updated if the option is removed
+     * \param argv the arguments of main
+     * \param exitCode set in the parent to the number of replicas that failed
+     * \return true in the parent after all replicas exit; false in a replica, or if the option
+     *         is not given, in which case the scenario continues in the current directory
+     */
+    static bool ForkReplicas(int& argc, char* argv[], int& exitCode);
+
+    /**
+     * Fork one child per directory and wait for them in the parent.
+     *
+     * \param dirs the working directory of each replica
+     * \param exitCode set in the parent to the number of replicas that failed
+     * \return true in the parent, false in a replica
+     */
+    static bool ForkReplicas(const std::vector<std::string>& dirs, int& exitCode);
+};
+
+} // namespace ns3
+
+#endif /* NETWORKGYM_REPLICA_HELPER_H */
@@ -0,0 +1,98 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#include "networkgym-rx-power-helper.h"
+
+#include "ns3/log.h"
+#include "ns3/wifi-net-device.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NetworkGymRxPowerHelper");
+
+/// Version of an entry that was never computed
+static constexpr uint64_t INVALID_VERSION = UINT64_MAX;
+
+NetworkGymRxPowerHelper::NetworkGymRxPowerHelper()
+{
+}
+
+void
+NetworkGymRxPowerHelper::Install(const NodeContainer& nodes,
+                                 Ptr<TgaxResidentialPropagationLossModel> lossModel)
+{
+    m_lossModel = lossModel;
+    uint32_t n = nodes.GetN();
+    m_mobility.resize(n);
+    m_phy.resize(n);
+    m_positionVersion.assign(n, 0);
+    m_txPowerVersion.assign(n, 0);
+    m_location.resize(n);
+    m_txPowerDbm.assign(n, 0);
+    m_snapshotPositionVersion.assign(n, INVALID_VERSION);
+    m_snapshotTxPowerVersion.assign(n, INVALID_VERSION);
+    m_rxPowerDbm.assign(n * n, 0);
+    m_version.assign(n * n, INVALID_VERSION);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        m_mobility[i] = nodes.Get(i)->GetObject<MobilityModel>();
+        NS_ABORT_MSG_UNLESS(m_mobility[i], "Node " << i << " has no MobilityModel");
+        m_mobility[i]->TraceConnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&NetworkGymRxPowerHelper::NotifyCourseChange, this).Bind(i));
+        auto device = DynamicCast<WifiNetDevice>(nodes.Get(i)->GetDevice(0));
+        NS_ABORT_MSG_UNLESS(device, "Device 0 of node " << i << " is not a WifiNetDevice");
+        m_phy[i] = device->GetPhy();
+    }
+}
+
+void
+NetworkGymRxPowerHelper::Snapshot()
+{
+    for (uint32_t i = 0; i < m_mobility.size(); ++i)
+    {
+        if (m_snapshotPositionVersion[i] != m_positionVersion[i])
+        {
+            m_location[i] = TgaxResidentialPropagationLossModel::GetLocation(m_mobility[i]);
+            m_snapshotPositionVersion[i] = m_positionVersion[i];
+        }
+        if (m_snapshotTxPowerVersion[i] != m_txPowerVersion[i])
+        {
+            m_txPowerDbm[i] = m_phy[i]->GetTxPowerStart();
+            m_snapshotTxPowerVersion[i] = m_txPowerVersion[i];
+        }
+    }
+}
+
+double
+NetworkGymRxPowerHelper::GetRxPowerDbm(uint32_t tx, uint32_t rx)
+{
+    uint32_t entry = tx * m_mobility.size() + rx;
+    // The sum only grows, so it equals the stored one only if no version changed since
+    uint64_t version = m_snapshotPositionVersion[tx] + m_snapshotPositionVersion[rx] +
+                       m_snapshotTxPowerVersion[tx];
+    if (m_version[entry] != version)
+    {
+        m_rxPowerDbm[entry] =
+            m_lossModel->CalcLocationRxPower(m_txPowerDbm[tx], m_location[tx], m_location[rx]);
+        m_version[entry] = version;
+    }
+    return m_rxPowerDbm[entry];
+}
+
+void
+NetworkGymRxPowerHelper::NotifyTxPowerChanged(uint32_t tx)
+{
+    ++m_txPowerVersion[tx];
+}
+
+void
+NetworkGymRxPowerHelper::NotifyCourseChange(uint32_t index, Ptr<const MobilityModel> model)
+{
+    ++m_positionVersion[index];
+}
+
+} // namespace ns3
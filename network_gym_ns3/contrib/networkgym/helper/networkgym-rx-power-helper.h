@@ -0,0 +1,94 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#ifndef NETWORKGYM_RX_POWER_HELPER_H
+#define NETWORKGYM_RX_POWER_HELPER_H
+
+#include "ns3/mobility-model.h"
+#include "ns3/node-container.h"
+#include "ns3/tgax-residential-propagation-loss-model.h"
+#include "ns3/wifi-phy.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup networkgym
+ * \brief Cached RX power matrix of Wi-Fi nodes.
+ *
+ * The RX power of each (TX, RX) pair is stored in a flat N x N array and computed on the
+ * first request. An entry is computed again only after the MobilityModel of either node
+ * fired its CourseChange trace, or after the TX power of the TX node was changed and
+ * NotifyTxPowerChanged was called.
+ *
+ * The entries are computed from a snapshot of the locations and the TX powers, which
+ * Snapshot takes on the simulator thread. GetRxPowerDbm only reads the snapshot, so the
+ * stale entries can be computed by the ranges of NetworkGymWorkerPool.
+ */
+class NetworkGymRxPowerHelper
+{
+  public:
+    NetworkGymRxPowerHelper();
+
+    /**
+     * Connect the CourseChange trace of every node. The TX power is read from the PHY of
+     * device 0 of each node.
+     *
+     * \param nodes the nodes, the matrix is indexed by their position in the container
+     * \param lossModel the propagation loss model
+     */
+    void Install(const NodeContainer& nodes, Ptr<TgaxResidentialPropagationLossModel> lossModel);
+
+    /**
+     * Read the location and the TX power of the nodes that moved or changed their TX power
+     * since the last call. Must be called on the simulator thread, before GetRxPowerDbm.
+     */
+    void Snapshot();
+
+    /**
+     * Only the snapshot is read, so the call can run on several threads as long as no pair is
+     * requested by two threads at once, e.g., when each thread has its own TX rows.
+     *
+     * \param tx the index of the TX node
+     * \param rx the index of the RX node
+     * \return the RX power (dBm) at rx when tx transmits, at the last Snapshot
+     */
+    double GetRxPowerDbm(uint32_t tx, uint32_t rx);
+
+    /**
+     * Invalidate the row of a node after its TX power was changed.
+     * \param tx the index of the TX node
+     */
+    void NotifyTxPowerChanged(uint32_t tx);
+
+  private:
+    /**
+     * Invalidate the row and the column of a node that moved.
+     * \param index the index of the node
+     * \param model the mobility model of the node
+     */
+    void NotifyCourseChange(uint32_t index, Ptr<const MobilityModel> model);
+
+    Ptr<TgaxResidentialPropagationLossModel> m_lossModel; //!< propagation loss model
+    std::vector<Ptr<MobilityModel>> m_mobility; //!< mobility model of each node
+    std::vector<Ptr<WifiPhy>> m_phy;         //!< PHY of device 0 of each node
+    std::vector<uint64_t> m_positionVersion; //!< incremented on each course change
+    std::vector<uint64_t> m_txPowerVersion;  //!< incremented on each TX power change
+
+    // Snapshot, indexed by node
+    std::vector<TgaxResidentialPropagationLossModel::Location> m_location; //!< location
+    std::vector<double> m_txPowerDbm;            //!< TX power (dBm)
+    std::vector<uint64_t> m_snapshotPositionVersion; //!< position version of the location
+    std::vector<uint64_t> m_snapshotTxPowerVersion;  //!< TX power version of the TX power
+
+    std::vector<double> m_rxPowerDbm;        //!< tx * N + rx -> RX power
+    std::vector<uint64_t> m_version;         //!< tx * N + rx -> versions the entry was computed with
+};
+
+} // namespace ns3
+
+#endif /* NETWORKGYM_RX_POWER_HELPER_H */
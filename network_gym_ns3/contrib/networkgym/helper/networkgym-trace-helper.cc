@@ -0,0 +1,388 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#include "networkgym-trace-helper.h"
+
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/wifi-net-device.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#ifdef NETWORKGYM_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NetworkGymTraceHelper");
+
+namespace
+{
+
+/// pcap link type of the radiotap header followed by the 802.11 frame
+constexpr uint32_t PCAP_LINKTYPE_RADIOTAP = 127;
+/// radiotap present bits of the fields written by the helper
+constexpr uint32_t RADIOTAP_FLAGS = 1 << 1;
+constexpr uint32_t RADIOTAP_CHANNEL = 1 << 3;
+constexpr uint32_t RADIOTAP_DBM_ANTSIGNAL = 1 << 5;
+constexpr uint32_t RADIOTAP_DBM_ANTNOISE = 1 << 6;
+/// radiotap flag of a frame that includes the FCS, as the frames of the monitor sniffer traces
+constexpr uint8_t RADIOTAP_FLAG_FCS_INCLUDED = 0x10;
+
+/// Append a little-endian integer to the buffer
+template <class T>
+void
+AppendLe(std::string& buffer, T value)
+{
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+        buffer.push_back(static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xff));
+    }
+}
+
+/// \return the dBm value clamped to the signed 8 bit radiotap field
+int8_t
+ClampDbm(double dbm)
+{
+    return static_cast<int8_t>(std::lround(std::min(127.0, std::max(-128.0, dbm))));
+}
+
+} // namespace
+
+NetworkGymTraceHelper::NetworkGymTraceHelper()
+    : m_format(PCAP),
+      m_compress(false),
+      m_bufferSize(1 << 20),
+      m_enabled(true)
+{
+}
+
+NetworkGymTraceHelper::~NetworkGymTraceHelper()
+{
+    Close();
+}
+
+void
+NetworkGymTraceHelper::SetFormat(Format format)
+{
+    m_format = format;
+}
+
+void
+NetworkGymTraceHelper::SetCompress(bool compress)
+{
+#ifndef NETWORKGYM_HAVE_ZLIB
+    if (compress)
+    {
+        NS_FATAL_ERROR("The compressed traces need the networkgym module built with zlib.");
+    }
+#endif
+    m_compress = compress;
+}
+
+void
+NetworkGymTraceHelper::SetBufferSize(uint32_t bytes)
+{
+    m_bufferSize = bytes;
+}
+
+void
+NetworkGymTraceHelper::Enable(const std::string& prefix, const NetDeviceContainer& devices)
+{
+    for (auto it = devices.Begin(); it != devices.End(); ++it)
+    {
+        auto device = DynamicCast<WifiNetDevice>(*it);
+        if (!device)
+        {
+            continue;
+        }
+        auto sink = std::make_unique<Sink>();
+        sink->nodeId = device->GetNode()->GetId();
+        sink->format = m_format;
+        sink->buffer.reserve(m_bufferSize);
+
+        std::ostringstream name;
+        name << prefix << "-" << sink->nodeId << "-" << device->GetIfIndex()
+             << (m_format == PCAP ? ".pcap" : ".tr") << (m_compress ? ".gz" : "");
+        if (m_compress)
+        {
+#ifdef NETWORKGYM_HAVE_ZLIB
+            sink->gzFile = gzopen(name.str().c_str(), "wb");
+#endif
+        }
+        else
+        {
+            sink->file = std::fopen(name.str().c_str(), "wb");
+        }
+        if (!sink->file && !sink->gzFile)
+        {
+            NS_FATAL_ERROR("Cannot open the trace file " << name.str() << ": "
+                                                         << std::strerror(errno));
+        }
+
+        if (m_format == PCAP)
+        {
+            std::string header;
+            AppendLe<uint32_t>(header, 0xa1b2c3d4); // microsecond timestamps
+            AppendLe<uint16_t>(header, 2);
+            AppendLe<uint16_t>(header, 4);
+            AppendLe<int32_t>(header, 0);
+            AppendLe<uint32_t>(header, 0);
+            AppendLe<uint32_t>(header, 65535);
+            AppendLe<uint32_t>(header, PCAP_LINKTYPE_RADIOTAP);
+            Write(*sink, header.data(), header.size());
+        }
+
+        uint32_t index = m_sinks.size();
+        m_sinks.push_back(std::move(sink));
+        for (uint8_t linkId = 0; linkId < device->GetNPhys(); ++linkId)
+        {
+            device->GetPhy(linkId)->TraceConnectWithoutContext(
+                "MonitorSnifferTx",
+                MakeCallback(&NetworkGymTraceHelper::NotifyMonitorSnifferTx, this).Bind(index));
+            device->GetPhy(linkId)->TraceConnectWithoutContext(
+                "MonitorSnifferRx",
+                MakeCallback(&NetworkGymTraceHelper::NotifyMonitorSnifferRx, this).Bind(index));
+        }
+    }
+}
+
+void
+NetworkGymTraceHelper::Start(Time startTime)
+{
+    m_enabled = false;
+    Simulator::Schedule(startTime, [this]() { m_enabled = true; });
+}
+
+void
+NetworkGymTraceHelper::Stop(Time stopTime)
+{
+    Simulator::Schedule(stopTime, [this]() {
+        m_enabled = false;
+        Flush();
+    });
+}
+
+void
+NetworkGymTraceHelper::Flush()
+{
+    for (auto& sink : m_sinks)
+    {
+        FlushSink(*sink);
+    }
+}
+
+NetDeviceContainer
+NetworkGymTraceHelper::SelectNodes(const NetDeviceContainer& devices, const std::string& nodeIds)
+{
+    if (nodeIds.empty())
+    {
+        return devices;
+    }
+    std::vector<uint32_t> ids;
+    std::stringstream ss(nodeIds);
+    std::string id;
+    while (std::getline(ss, id, ','))
+    {
+        if (!id.empty())
+        {
+            ids.push_back(std::stoul(id));
+        }
+    }
+    NetDeviceContainer selected;
+    for (auto it = devices.Begin(); it != devices.End(); ++it)
+    {
+        if (std::find(ids.begin(), ids.end(), (*it)->GetNode()->GetId()) != ids.end())
+        {
+            selected.Add(*it);
+        }
+    }
+    return selected;
+}
+
+void
+NetworkGymTraceHelper::Write(Sink& sink, const void* data, size_t size)
+{
+    sink.buffer.append(static_cast<const char*>(data), size);
+    if (sink.buffer.size() >= m_bufferSize)
+    {
+        FlushSink(sink);
+    }
+}
+
+void
+NetworkGymTraceHelper::FlushSink(Sink& sink)
+{
+    if (sink.buffer.empty())
+    {
+        return;
+    }
+    if (sink.file)
+    {
+        std::fwrite(sink.buffer.data(), 1, sink.buffer.size(), sink.file);
+        std::fflush(sink.file);
+    }
+#ifdef NETWORKGYM_HAVE_ZLIB
+    if (sink.gzFile)
+    {
+        gzwrite(static_cast<gzFile>(sink.gzFile), sink.buffer.data(), sink.buffer.size());
+    }
+#endif
+    sink.buffer.clear();
+}
+
+void
+NetworkGymTraceHelper::WritePcapRecord(Sink& sink,
+                                       Ptr<const Packet> packet,
+                                       uint16_t channelFreqMhz,
+                                       const SignalNoiseDbm* signalNoise)
+{
+    uint16_t radiotapLength = signalNoise ? 16 : 14;
+    uint32_t frameSize = packet->GetSize();
+    uint32_t recordSize = radiotapLength + frameSize;
+    int64_t us = Simulator::Now().GetMicroSeconds();
+
+    std::string& buffer = sink.buffer;
+    AppendLe<uint32_t>(buffer, us / 1000000);
+    AppendLe<uint32_t>(buffer, us % 1000000);
+    AppendLe<uint32_t>(buffer, recordSize);
+    AppendLe<uint32_t>(buffer, recordSize);
+
+    // radiotap header: version, pad, length, present, then the fields in the order of their bits
+    AppendLe<uint8_t>(buffer, 0);
+    AppendLe<uint8_t>(buffer, 0);
+    AppendLe<uint16_t>(buffer, radiotapLength);
+    AppendLe<uint32_t>(buffer,
+                       RADIOTAP_FLAGS | RADIOTAP_CHANNEL |
+                           (signalNoise ? RADIOTAP_DBM_ANTSIGNAL | RADIOTAP_DBM_ANTNOISE : 0));
+    AppendLe<uint8_t>(buffer, RADIOTAP_FLAG_FCS_INCLUDED);
+    AppendLe<uint8_t>(buffer, 0); // the channel field is 2 byte aligned
+    AppendLe<uint16_t>(buffer, channelFreqMhz);
+    AppendLe<uint16_t>(buffer, channelFreqMhz < 3000 ? 0x0080 : 0x0100); // 2 GHz or 5 GHz
+    if (signalNoise)
+    {
+        AppendLe<int8_t>(buffer, ClampDbm(signalNoise->signal));
+        AppendLe<int8_t>(buffer, ClampDbm(signalNoise->noise));
+    }
+
+    size_t offset = buffer.size();
+    buffer.resize(offset + frameSize);
+    packet->CopyData(reinterpret_cast<uint8_t*>(&buffer[offset]), frameSize);
+    if (buffer.size() >= m_bufferSize)
+    {
+        FlushSink(sink);
+    }
+}
+
+void
+NetworkGymTraceHelper::WriteAsciiRecord(Sink& sink,
+                                        char direction,
+                                        Ptr<const Packet> packet,
+                                        uint16_t channelFreqMhz,
+                                        WifiMode mode,
+                                        const SignalNoiseDbm* signalNoise)
+{
+    std::ostringstream line;
+    line << direction << " " << Simulator::Now().GetSeconds() << " node " << sink.nodeId
+         << " freq " << channelFreqMhz << " mode " << mode.GetUniqueName() << " size "
+         << packet->GetSize();
+    if (signalNoise)
+    {
+        line << " signal " << signalNoise->signal << " noise " << signalNoise->noise;
+    }
+    line << "\n";
+    const std::string& text = line.str();
+    Write(sink, text.data(), text.size());
+}
+
+void
+NetworkGymTraceHelper::NotifyMonitorSnifferTx(uint32_t index,
+                                              Ptr<const Packet> packet,
+                                              uint16_t channelFreqMhz,
+                                              WifiTxVector txVector,
+                                              MpduInfo aMpdu,
+                                              uint16_t staId)
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+    Sink& sink = *m_sinks[index];
+    if (sink.format == PCAP)
+    {
+        WritePcapRecord(sink, packet, channelFreqMhz, nullptr);
+    }
+    else
+    {
+        WriteAsciiRecord(sink,
+                         't',
+                         packet,
+                         channelFreqMhz,
+                         txVector.IsMu() ? txVector.GetMode(staId) : txVector.GetMode(),
+                         nullptr);
+    }
+}
+
+void
+NetworkGymTraceHelper::NotifyMonitorSnifferRx(uint32_t index,
+                                              Ptr<const Packet> packet,
+                                              uint16_t channelFreqMhz,
+                                              WifiTxVector txVector,
+                                              MpduInfo aMpdu,
+                                              SignalNoiseDbm signalNoise,
+                                              uint16_t staId)
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+    Sink& sink = *m_sinks[index];
+    if (sink.format == PCAP)
+    {
+        WritePcapRecord(sink, packet, channelFreqMhz, &signalNoise);
+    }
+    else
+    {
+        WriteAsciiRecord(sink,
+                         'r',
+                         packet,
+                         channelFreqMhz,
+                         txVector.IsMu() ? txVector.GetMode(staId) : txVector.GetMode(),
+                         &signalNoise);
+    }
+}
+
+void
+NetworkGymTraceHelper::Close()
+{
+    for (auto& sink : m_sinks)
+    {
+        FlushSink(*sink);
+        if (sink->file)
+        {
+            std::fclose(sink->file);
+            sink->file = nullptr;
+        }
+#ifdef NETWORKGYM_HAVE_ZLIB
+        if (sink->gzFile)
+        {
+            gzclose(static_cast<gzFile>(sink->gzFile));
+            sink->gzFile = nullptr;
+        }
+#endif
+    }
+    m_sinks.clear();
+}
+
+} // namespace ns3
@@ -0,0 +1,194 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#ifndef NETWORKGYM_TRACE_HELPER_H
+#define NETWORKGYM_TRACE_HELPER_H
+
+#include "ns3/net-device-container.h"
+#include "ns3/nstime.h"
+#include "ns3/wifi-phy.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup networkgym
+ * \brief Pcap or ascii tracing of selected Wi-Fi devices within a time window.
+ *
+ * Unlike WifiPhyHelper::EnablePcap, the traces are only written between Start and Stop,
+ * e.g., for the last episode only, and each file is written through an in-memory buffer
+ * that is flushed in large blocks. With SetCompress, the files are gzip compressed if the
+ * module is built with zlib (NETWORKGYM_HAVE_ZLIB). The pcap files use the radiotap link
+ * type with the flags, channel and, for received frames, the signal and noise fields.
+ *
+ * The helper must outlive the simulation. The buffers are flushed at Stop, by Flush, and
+ * when the helper is destroyed.
+ */
+class NetworkGymTraceHelper
+{
+  public:
+    /// Trace file format
+    enum Format
+    {
+        PCAP,  //!< one radiotap pcap file per device
+        ASCII, //!< one text line per frame, one file per device
+    };
+
+    NetworkGymTraceHelper();
+    ~NetworkGymTraceHelper();
+
+    NetworkGymTraceHelper(const NetworkGymTraceHelper&) = delete;
+    NetworkGymTraceHelper& operator=(const NetworkGymTraceHelper&) = delete;
+
+    /**
+     * \param format the format of the files created by the following Enable calls
+     */
+    void SetFormat(Format format);
+
+    /**
+     * \param compress whether the files created by the following Enable calls are gzip compressed
+     */
+    void SetCompress(bool compress);
+
+    /**
+     * \param bytes the buffer size of each file, the buffer is written out when it is full
+     */
+    void SetBufferSize(uint32_t bytes);
+
+    /**
+     * Create one file per device, named prefix-node-device.pcap (or .tr), with .gz appended
+     * if compressed, and connect the monitor sniffer traces of the device PHYs.
+     *
+     * \param prefix the file name prefix
+     * \param devices the Wi-Fi devices
+     */
+    void Enable(const std::string& prefix, const NetDeviceContainer& devices);
+
+    /**
+     * \param startTime the time the tracing starts, the tracing starts at 0 if not called
+     */
+    void Start(Time startTime);
+
+    /**
+     * \param stopTime the time the tracing stops and the files are flushed
+     */
+    void Stop(Time stopTime);
+
+    /**
+     * Write the buffered frames of all files.
+     */
+    void Flush();
+
+    /**
+     * \param devices the devices to select from
+     * \param nodeIds comma separated node IDs, e.g., "0,3,4"; empty selects all devices
+     * \return the devices installed on the listed nodes
+     */
+    static NetDeviceContainer SelectNodes(const NetDeviceContainer& devices,
+                                          const std::string& nodeIds);
+
+  private:
+    /// A buffered, optionally compressed trace file
+    struct Sink
+    {
+        std::string buffer;        //!< frames that are not written yet
+        std::FILE* file{nullptr};  //!< the file if not compressed
+        void* gzFile{nullptr};     //!< the zlib gzFile if compressed
+        uint32_t nodeId{0};        //!< node ID of the device
+        Format format{PCAP};       //!< file format
+    };
+
+    /**
+     * Append the bytes to the sink, and write the buffer out if it is full.
+     * \param sink the sink
+     * \param data the bytes
+     * \param size the number of bytes
+     */
+    void Write(Sink& sink, const void* data, size_t size);
+
+    /**
+     * \param sink the sink whose buffer is written out
+     */
+    void FlushSink(Sink& sink);
+
+    /**
+     * Append the pcap record header, the radiotap header and the frame.
+     * \param sink the sink
+     * \param packet the frame including the FCS
+     * \param channelFreqMhz the channel center frequency
+     * \param signalNoise the signal and noise of a received frame, nullptr when transmitted
+     */
+    void WritePcapRecord(Sink& sink,
+                         Ptr<const Packet> packet,
+                         uint16_t channelFreqMhz,
+                         const SignalNoiseDbm* signalNoise);
+
+    /**
+     * \param sink the sink
+     * \param direction 't' for transmitted, 'r' for received
+     * \param packet the frame
+     * \param channelFreqMhz the channel center frequency
+     * \param mode the mode of the frame
+     * \param signalNoise the signal and noise of a received frame, nullptr when transmitted
+     */
+    void WriteAsciiRecord(Sink& sink,
+                          char direction,
+                          Ptr<const Packet> packet,
+                          uint16_t channelFreqMhz,
+                          WifiMode mode,
+                          const SignalNoiseDbm* signalNoise);
+
+    /**
+     * \param index the sink index
+     * \param packet the transmitted frame
+     * \param channelFreqMhz the channel center frequency
+     * \param txVector the TX vector
+     * \param aMpdu the A-MPDU information
+     * \param staId the STA-ID
+     */
+    void NotifyMonitorSnifferTx(uint32_t index,
+                                Ptr<const Packet> packet,
+                                uint16_t channelFreqMhz,
+                                WifiTxVector txVector,
+                                MpduInfo aMpdu,
+                                uint16_t staId);
+
+    /**
+     * \param index the sink index
+     * \param packet the received frame
+     * \param channelFreqMhz the channel center frequency
+     * \param txVector the TX vector
+     * \param aMpdu the A-MPDU information
+     * \param signalNoise the signal and noise
+     * \param staId the STA-ID
+     */
+    void NotifyMonitorSnifferRx(uint32_t index,
+                                Ptr<const Packet> packet,
+                                uint16_t channelFreqMhz,
+                                WifiTxVector txVector,
+                                MpduInfo aMpdu,
+                                SignalNoiseDbm signalNoise,
+                                uint16_t staId);
+
+    /**
+     * Flush and close all files.
+     */
+    void Close();
+
+    Format m_format;                            //!< format of the new files
+    bool m_compress;                            //!< whether the new files are compressed
+    uint32_t m_bufferSize;                      //!< buffer size of each file
+    bool m_enabled;                             //!< whether tracing is running
+    std::vector<std::unique_ptr<Sink>> m_sinks; //!< one per device, indexed by the bound index
+};
+
+} // namespace ns3
+
+#endif /* NETWORKGYM_TRACE_HELPER_H */
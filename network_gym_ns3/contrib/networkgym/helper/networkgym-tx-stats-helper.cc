@@ -0,0 +1,201 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#include "networkgym-tx-stats-helper.h"
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/wifi-mpdu.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-psdu.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NetworkGymTxStatsHelper");
+
+NetworkGymTxStatsHelper::NetworkGymTxStatsHelper()
+    : m_enabled(true)
+{
+}
+
+void
+NetworkGymTxStatsHelper::Enable(const NetDeviceContainer& devices)
+{
+    for (auto it = devices.Begin(); it != devices.End(); ++it)
+    {
+        auto device = DynamicCast<WifiNetDevice>(*it);
+        if (!device)
+        {
+            continue;
+        }
+        uint32_t nodeId = device->GetNode()->GetId();
+        GetCounters(nodeId);
+        device->GetMac()->TraceConnectWithoutContext(
+            "AckedMpdu",
+            MakeCallback(&NetworkGymTxStatsHelper::NotifyAcked, this).Bind(nodeId));
+        device->GetMac()->TraceConnectWithoutContext(
+            "DroppedMpdu",
+            MakeCallback(&NetworkGymTxStatsHelper::NotifyDropped, this).Bind(nodeId));
+        for (uint8_t linkId = 0; linkId < device->GetNPhys(); ++linkId)
+        {
+            device->GetPhy(linkId)->TraceConnectWithoutContext(
+                "PhyTxPsduBegin",
+                MakeCallback(&NetworkGymTxStatsHelper::NotifyTxStart, this).Bind(nodeId));
+        }
+    }
+}
+
+void
+NetworkGymTxStatsHelper::Start(Time startTime)
+{
+    m_enabled = false;
+    Simulator::Schedule(startTime, [this]() {
+        m_enabled = true;
+        for (auto& counters : m_counters)
+        {
+            counters = NodeCounters();
+        }
+        m_txStartTime.clear();
+    });
+}
+
+void
+NetworkGymTxStatsHelper::Stop(Time stopTime)
+{
+    Simulator::Schedule(stopTime, [this]() {
+        m_enabled = false;
+        m_txStartTime.clear();
+    });
+}
+
+void
+NetworkGymTxStatsHelper::Reset()
+{
+    for (auto& counters : m_counters)
+    {
+        counters.stepSuccesses = 0;
+        counters.stepFailures = 0;
+        counters.stepAccessDelaySum = Time();
+        counters.stepAccessDelayCount = 0;
+        counters.lastAckValid = false;
+    }
+}
+
+NetworkGymTxStatsHelper::NodeCounters&
+NetworkGymTxStatsHelper::GetCounters(uint32_t nodeId)
+{
+    if (nodeId >= m_counters.size())
+    {
+        m_counters.resize(nodeId + 1);
+    }
+    return m_counters[nodeId];
+}
+
+uint32_t
+NetworkGymTxStatsHelper::GetStepSuccesses(uint32_t nodeId) const
+{
+    return nodeId < m_counters.size() ? m_counters[nodeId].stepSuccesses : 0;
+}
+
+uint32_t
+NetworkGymTxStatsHelper::GetStepFailures(uint32_t nodeId) const
+{
+    return nodeId < m_counters.size() ? m_counters[nodeId].stepFailures : 0;
+}
+
+uint64_t
+NetworkGymTxStatsHelper::GetTotalSuccesses(uint32_t nodeId) const
+{
+    return nodeId < m_counters.size() ? m_counters[nodeId].totalSuccesses : 0;
+}
+
+uint64_t
+NetworkGymTxStatsHelper::GetTotalFailures(uint32_t nodeId) const
+{
+    return nodeId < m_counters.size() ? m_counters[nodeId].totalFailures : 0;
+}
+
+uint32_t
+NetworkGymTxStatsHelper::GetStepAccessDelayCount(uint32_t nodeId) const
+{
+    return nodeId < m_counters.size() ? m_counters[nodeId].stepAccessDelayCount : 0;
+}
+
+Time
+NetworkGymTxStatsHelper::GetStepMeanAccessDelay(uint32_t nodeId) const
+{
+    if (GetStepAccessDelayCount(nodeId) == 0)
+    {
+        return Time();
+    }
+    const auto& counters = m_counters[nodeId];
+    return counters.stepAccessDelaySum / counters.stepAccessDelayCount;
+}
+
+void
+NetworkGymTxStatsHelper::NotifyTxStart(uint32_t nodeId,
+                                       WifiConstPsduMap psduMap,
+                                       WifiTxVector txVector,
+                                       double txPowerW)
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+    for (const auto& [staId, psdu] : psduMap)
+    {
+        for (const auto& mpdu : *psdu)
+        {
+            // Group addressed MPDUs are never acknowledged
+            if (!mpdu->GetHeader().IsQosData() || mpdu->GetHeader().GetAddr1().IsGroup())
+            {
+                continue;
+            }
+            // Keep the start of the first transmission, retransmissions do not overwrite it
+            m_txStartTime.emplace(mpdu->GetPacket()->GetUid(), Simulator::Now());
+        }
+    }
+}
+
+void
+NetworkGymTxStatsHelper::NotifyAcked(uint32_t nodeId, Ptr<const WifiMpdu> mpdu)
+{
+    auto it = m_txStartTime.find(mpdu->GetPacket()->GetUid());
+    if (!m_enabled || it == m_txStartTime.end())
+    {
+        return;
+    }
+    auto& counters = GetCounters(nodeId);
+    ++counters.stepSuccesses;
+    ++counters.totalSuccesses;
+    if (counters.lastAckValid)
+    {
+        counters.stepAccessDelaySum += it->second - counters.lastAckTime;
+        ++counters.stepAccessDelayCount;
+    }
+    counters.lastAckTime = Simulator::Now();
+    counters.lastAckValid = true;
+    m_txStartTime.erase(it);
+}
+
+void
+NetworkGymTxStatsHelper::NotifyDropped(uint32_t nodeId,
+                                       WifiMacDropReason reason,
+                                       Ptr<const WifiMpdu> mpdu)
+{
+    if (!m_enabled || !mpdu->GetHeader().IsQosData())
+    {
+        return;
+    }
+    // Also count the MPDUs dropped before their first transmission
+    auto& counters = GetCounters(nodeId);
+    ++counters.stepFailures;
+    ++counters.totalFailures;
+    m_txStartTime.erase(mpdu->GetPacket()->GetUid());
+}
+
+} // namespace ns3
@@ -0,0 +1,147 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#ifndef NETWORKGYM_TX_STATS_HELPER_H
+#define NETWORKGYM_TX_STATS_HELPER_H
+
+#include "ns3/net-device-container.h"
+#include "ns3/nstime.h"
+#include "ns3/wifi-mac.h"
+#include "ns3/wifi-phy.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup networkgym
+ * \brief Per step TX counters of Wi-Fi nodes.
+ *
+ * Unlike WifiTxStatsHelper, no per MPDU record is kept after an MPDU is acknowledged or
+ * dropped. The helper counts the successes and failures of each node since the last Reset,
+ * and accumulates the access delay, i.e., the TX start time of an MPDU minus the ACK time of
+ * the previous successful MPDU of the same node, for the pairs of MPDUs acknowledged in the
+ * same step. Only QoS data MPDUs are counted, as in WifiTxStatsHelper, and the group
+ * addressed ones, which are never acknowledged, are not tracked. Call Reset at each
+ * measurement boundary; the cost of a step is linear in the number of new MPDUs.
+ */
+class NetworkGymTxStatsHelper
+{
+  public:
+    NetworkGymTxStatsHelper();
+
+    /**
+     * Connect the MAC and PHY traces of the Wi-Fi devices.
+     * \param devices the Wi-Fi devices
+     */
+    void Enable(const NetDeviceContainer& devices);
+
+    /**
+     * \param startTime the time the counting starts
+     */
+    void Start(Time startTime);
+
+    /**
+     * Stop the counting and drop the records of the MPDUs still in flight.
+     * \param stopTime the time the counting stops
+     */
+    void Stop(Time stopTime);
+
+    /**
+     * Start a new step: drop the step counters and the access delay accumulator.
+     */
+    void Reset();
+
+    /**
+     * \param nodeId the node ID
+     * \return the number of MPDUs of the node acknowledged in this step
+     */
+    uint32_t GetStepSuccesses(uint32_t nodeId) const;
+
+    /**
+     * \param nodeId the node ID
+     * \return the number of MPDUs of the node dropped in this step
+     */
+    uint32_t GetStepFailures(uint32_t nodeId) const;
+
+    /**
+     * \param nodeId the node ID
+     * \return the number of MPDUs of the node acknowledged since Start
+     */
+    uint64_t GetTotalSuccesses(uint32_t nodeId) const;
+
+    /**
+     * \param nodeId the node ID
+     * \return the number of MPDUs of the node dropped since Start
+     */
+    uint64_t GetTotalFailures(uint32_t nodeId) const;
+
+    /**
+     * \param nodeId the node ID
+     * \return the number of access delay samples of the node in this step
+     */
+    uint32_t GetStepAccessDelayCount(uint32_t nodeId) const;
+
+    /**
+     * \param nodeId the node ID
+     * \return the mean access delay of the node in this step, zero without samples
+     */
+    Time GetStepMeanAccessDelay(uint32_t nodeId) const;
+
+  private:
+    /// Counters of one node
+    struct NodeCounters
+    {
+        uint32_t stepSuccesses{0};      //!< successes in this step
+        uint32_t stepFailures{0};       //!< failures in this step
+        uint64_t totalSuccesses{0};     //!< successes since Start
+        uint64_t totalFailures{0};      //!< failures since Start
+        Time stepAccessDelaySum;        //!< sum of the access delay samples in this step
+        uint32_t stepAccessDelayCount{0}; //!< number of access delay samples in this step
+        Time lastAckTime;               //!< ACK time of the last success in this step
+        bool lastAckValid{false};       //!< whether lastAckTime belongs to this step
+    };
+
+    /**
+     * \param nodeId the node ID
+     * \return the counters of the node, created if needed
+     */
+    NodeCounters& GetCounters(uint32_t nodeId);
+
+    /**
+     * Record the first TX start time of the QoS data MPDUs in flight.
+     * \param nodeId the node ID of the transmitter
+     * \param psduMap the PSDU map
+     * \param txVector the TX vector
+     * \param txPowerW the TX power
+     */
+    void NotifyTxStart(uint32_t nodeId,
+                       WifiConstPsduMap psduMap,
+                       WifiTxVector txVector,
+                       double txPowerW);
+
+    /**
+     * \param nodeId the node ID of the transmitter
+     * \param mpdu the acknowledged MPDU
+     */
+    void NotifyAcked(uint32_t nodeId, Ptr<const WifiMpdu> mpdu);
+
+    /**
+     * \param nodeId the node ID of the transmitter
+     * \param reason the drop reason
+     * \param mpdu the dropped MPDU
+     */
+    void NotifyDropped(uint32_t nodeId, WifiMacDropReason reason, Ptr<const WifiMpdu> mpdu);
+
+    bool m_enabled;                                   //!< whether counting is running
+    std::vector<NodeCounters> m_counters;             //!< indexed by node ID
+    std::unordered_map<uint64_t, Time> m_txStartTime; //!< packet UID -> first TX start, in flight only
+};
+
+} // namespace ns3
+
+#endif /* NETWORKGYM_TX_STATS_HELPER_H */
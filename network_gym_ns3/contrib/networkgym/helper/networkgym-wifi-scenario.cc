@@ -0,0 +1,546 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#include "networkgym-wifi-scenario.h"
+
+#include "ns3/buildings-helper.h"
+#include "ns3/double.h"
+#include "ns3/he-configuration.h"
+#include "ns3/he-phy.h"
+#include "ns3/integer.h"
+#include "ns3/log.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/ssid.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/wifi-mac.h"
+#include "ns3/wifi-net-device.h"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <tuple>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NetworkGymWifiScenario");
+
+NetworkGymWifiScenario::NetworkGymWifiScenario()
+    : m_verbosity(0),
+      m_installCalls(0),
+      m_setupStart(std::chrono::steady_clock::now())
+{
+}
+
+std::vector<std::string>
+NetworkGymWifiScenario::CsvSplit(const std::string& source, char delimiter)
+{
+    std::vector<std::string> ret;
+    std::string word;
+    const char specials[2] = {'"', delimiter};
+
+    bool inQuote = false;
+    size_t i = 0;
+    while (i < source.size())
+    {
+        if (source[i] == '"')
+        {
+            if (!inQuote)
+            {
+                inQuote = true;
+            }
+            else if (i + 1 < source.size() && source[i + 1] == '"')
+            {
+                word += '"';
+                ++i;
+            }
+            else
+            {
+                inQuote = false;
+            }
+            ++i;
+            continue;
+        }
+        if (!inQuote && source[i] == delimiter)
+        {
+            ret.push_back(std::move(word));
+            word.clear();
+            ++i;
+            continue;
+        }
+        // Copy the characters up to the next quote, or delimiter outside quotes, at once
+        size_t end = inQuote ? source.find('"', i) : source.find_first_of(specials, i, 2);
+        if (end == std::string::npos)
+        {
+            end = source.size();
+        }
+        word.append(source, i, end - i);
+        i = end;
+    }
+    ret.push_back(std::move(word));
+
+    return ret;
+}
+
+void
+NetworkGymWifiScenario::ReadConfigFile(const std::string& filename)
+{
+    SetNodeConfigs(NetworkGymNodeConfigLoader::Load(filename));
+}
+
+void
+NetworkGymWifiScenario::SetNodeConfigs(std::vector<NetworkGymNodeConfig> configs)
+{
+    m_config = std::move(configs);
+}
+
+void
+NetworkGymWifiScenario::SetVerbosity(uint32_t verbosity)
+{
+    m_verbosity = verbosity;
+}
+
+void
+NetworkGymWifiScenario::AddPropagationLoss(YansWifiChannelHelper& channel,
+                                           double frequency,
+                                           const std::string& model)
+{
+    // Reference loss for Friis at 1 m and log distance exponent of each band
+    double referenceLoss = 40.046;
+    double exponent = 2.0;
+    double tgaxFrequency = 2.4e9;
+    if (frequency == 6)
+    {
+        referenceLoss = 49.013;
+        tgaxFrequency = 6e9;
+    }
+    else if (frequency == 5)
+    {
+        referenceLoss = 50;
+        exponent = 3.0;
+        tgaxFrequency = 5e9;
+    }
+
+    if (model == "log")
+    {
+        channel.AddPropagationLoss("ns3::LogDistancePropagationLossModel",
+                                   "Exponent",
+                                   DoubleValue(exponent),
+                                   "ReferenceDistance",
+                                   DoubleValue(1.0),
+                                   "ReferenceLoss",
+                                   DoubleValue(referenceLoss));
+    }
+    else if (model == "tgax")
+    {
+        channel.AddPropagationLoss("ns3::TgaxResidentialPropagationLossModel",
+                                   "Frequency",
+                                   DoubleValue(tgaxFrequency),
+                                   "ShadowSigma",
+                                   DoubleValue(5.0));
+    }
+    else if (model == "fixed")
+    {
+        channel.AddPropagationLoss("ns3::FixedRssLossModel", "Rss", DoubleValue(-71));
+    }
+}
+
+void
+NetworkGymWifiScenario::CreateNodes(uint32_t apCount, uint32_t staCount)
+{
+    m_apNodes.Create(apCount);
+    m_staNodes.Create(staCount);
+    m_wifiNodes.Add(m_apNodes);
+    m_wifiNodes.Add(m_staNodes);
+
+    uint32_t maxNodeId = 0;
+    for (uint32_t i = 0; i < m_wifiNodes.GetN(); ++i)
+    {
+        maxNodeId = std::max(maxNodeId, m_wifiNodes.Get(i)->GetId());
+    }
+    m_bss.assign(maxNodeId + 1, 0);
+    for (uint32_t i = 0; i < apCount; ++i)
+    {
+        m_bss[m_apNodes.Get(i)->GetId()] = i;
+    }
+    for (uint32_t i = 0; i < staCount; ++i)
+    {
+        m_bss[m_staNodes.Get(i)->GetId()] = i % apCount;
+    }
+}
+
+void
+NetworkGymWifiScenario::SetPhyConfig(YansWifiPhyHelper& phy, uint32_t nodeId) const
+{
+    NS_ABORT_MSG_IF(nodeId >= m_config.size() || !m_config[nodeId].configured,
+                    "Node " << nodeId << " is not in the configuration file");
+    const NetworkGymNodeConfig& config = m_config[nodeId];
+    phy.Set("CcaSensitivity", DoubleValue(config.ccaSensitivityDbm));
+    phy.SetPreambleDetectionModel("ns3::ThresholdPreambleDetectionModel",
+                                  "MinimumRssi",
+                                  DoubleValue(config.ccaSensitivityDbm));
+    phy.Set("TxPowerStart", DoubleValue(config.txPowerDbm));
+    phy.Set("TxPowerEnd", DoubleValue(config.txPowerDbm));
+    phy.Set("ChannelSettings",
+            StringValue("{" + std::to_string(config.channelNumber) + "," +
+                        std::to_string(config.channelWidth) + ", BAND_5GHZ, 0}"));
+}
+
+void
+NetworkGymWifiScenario::InstallDevices(WifiHelper& wifi, YansWifiPhyHelper& phy, bool setBssColor)
+{
+    uint64_t beaconInterval = 100 * 1024;
+    uint32_t apCount = m_apNodes.GetN();
+
+    WifiMacHelper mac;
+    for (uint32_t i = 0; i < apCount; ++i)
+    {
+        Ptr<Node> node = m_apNodes.Get(i);
+        SetPhyConfig(phy, node->GetId());
+        std::string ssi = "BSS-" + std::to_string(i);
+        mac.SetType("ns3::ApWifiMac",
+                    "BeaconInterval",
+                    TimeValue(MicroSeconds(beaconInterval)),
+                    "Ssid",
+                    SsidValue(Ssid(ssi)));
+        NetDeviceContainer tmp = wifi.Install(phy, mac, node);
+        m_installCalls++;
+        if (setBssColor)
+        {
+            DynamicCast<WifiNetDevice>(tmp.Get(0))->GetHeConfiguration()->SetAttribute(
+                "BssColor",
+                UintegerValue(i + 1));
+        }
+        m_apDevices.Add(tmp.Get(0));
+        m_devices.Add(tmp.Get(0));
+        if (m_verbosity > 0)
+        {
+            std::cout << "AP MAC: " << tmp.Get(0)->GetAddress() << "," << ssi << "\n";
+        }
+    }
+
+    // The STAs with the same BSS and PHY configuration are installed in one call, the PHY and MAC
+    // attributes are set once per group instead of once per STA
+    typedef std::tuple<uint32_t, double, double, uint16_t, uint16_t> GroupKey;
+    std::map<GroupKey, NodeContainer> groups;
+    for (uint32_t i = 0; i < m_staNodes.GetN(); ++i)
+    {
+        Ptr<Node> node = m_staNodes.Get(i);
+        uint32_t nodeId = node->GetId();
+        NS_ABORT_MSG_IF(nodeId >= m_config.size() || !m_config[nodeId].configured,
+                        "Node " << nodeId << " is not in the configuration file");
+        const NetworkGymNodeConfig& config = m_config[nodeId];
+        groups[GroupKey(m_bss[nodeId],
+                        config.ccaSensitivityDbm,
+                        config.txPowerDbm,
+                        config.channelWidth,
+                        config.channelNumber)]
+            .Add(node);
+    }
+
+    std::vector<Ptr<NetDevice>> staDevices(m_bss.size());
+    for (const auto& [key, nodes] : groups)
+    {
+        uint32_t bss = std::get<0>(key);
+        SetPhyConfig(phy, nodes.Get(0)->GetId());
+        std::string ssi = "BSS-" + std::to_string(bss);
+        mac.SetType("ns3::StaWifiMac",
+                    "MaxMissedBeacons",
+                    UintegerValue(std::numeric_limits<uint32_t>::max()),
+                    "Ssid",
+                    SsidValue(Ssid(ssi)));
+        NetDeviceContainer tmp = wifi.Install(phy, mac, nodes);
+        m_installCalls++;
+        for (uint32_t k = 0; k < tmp.GetN(); ++k)
+        {
+            if (setBssColor)
+            {
+                DynamicCast<WifiNetDevice>(tmp.Get(k))->GetHeConfiguration()->SetAttribute(
+                    "BssColor",
+                    UintegerValue(bss + 1));
+            }
+            staDevices[nodes.Get(k)->GetId()] = tmp.Get(k);
+        }
+    }
+
+    // The device containers stay in node ID order
+    for (uint32_t i = 0; i < m_staNodes.GetN(); ++i)
+    {
+        uint32_t nodeId = m_staNodes.Get(i)->GetId();
+        m_devices.Add(staDevices[nodeId]);
+        m_staDevices.Add(staDevices[nodeId]);
+        if (m_verbosity > 0)
+        {
+            const NetworkGymNodeConfig& config = m_config[nodeId];
+            std::cout << "STA node id " << nodeId << " : " << config.trafficType << ", "
+                      << config.ccaSensitivityDbm << ", " << config.txPowerDbm << ", "
+                      << config.channelWidth << ", " << config.channelNumber << ", \n";
+            std::cout << "STA: " << i << "\n";
+            std::cout << "STA MAC: " << staDevices[nodeId]->GetAddress() << ",BSS-" << m_bss[nodeId]
+                      << "\n";
+        }
+    }
+
+    // Resolved once, the actions reconfigure these objects without a cast per node and step
+    m_handles.assign(m_bss.size(), WifiHandles());
+    m_bssNodes.assign(apCount, std::vector<uint32_t>());
+    for (uint32_t i = 0; i < m_devices.GetN(); ++i)
+    {
+        uint32_t nodeId = m_devices.Get(i)->GetNode()->GetId();
+        WifiHandles& handles = m_handles[nodeId];
+        handles.device = DynamicCast<WifiNetDevice>(m_devices.Get(i));
+        handles.phy = handles.device->GetPhy();
+        handles.stationManager = handles.device->GetRemoteStationManager();
+        if (handles.device->GetHeConfiguration())
+        {
+            auto hePhy = DynamicCast<HePhy>(handles.phy->GetPhyEntity(WIFI_MOD_CLASS_HE));
+            handles.obssPdAlgorithm = hePhy->GetObssPdAlgorithm();
+        }
+        m_bssNodes[m_bss[nodeId]].push_back(nodeId);
+    }
+    for (auto& nodes : m_bssNodes)
+    {
+        std::sort(nodes.begin(), nodes.end());
+    }
+}
+
+void
+NetworkGymWifiScenario::SetMaxAmpduSize(uint32_t maxAmpduSize)
+{
+    for (uint32_t i = 0; i < m_devices.GetN(); ++i)
+    {
+        Ptr<WifiMac> mac = DynamicCast<WifiNetDevice>(m_devices.Get(i))->GetMac();
+        mac->SetAttribute("BE_MaxAmpduSize", UintegerValue(maxAmpduSize));
+        mac->SetAttribute("BK_MaxAmpduSize", UintegerValue(maxAmpduSize));
+        mac->SetAttribute("VO_MaxAmpduSize", UintegerValue(maxAmpduSize));
+        mac->SetAttribute("VI_MaxAmpduSize", UintegerValue(maxAmpduSize));
+    }
+}
+
+void
+NetworkGymWifiScenario::CreateRooms(uint32_t xRoomCount,
+                                    uint32_t yRoomCount,
+                                    double boxSize,
+                                    int64_t stream)
+{
+    double floorCount = 1;
+    m_building = CreateObject<Building>();
+    m_building->SetBoundaries(
+        Box(0, boxSize * xRoomCount, 0, boxSize * yRoomCount, 0, 3 * floorCount));
+    m_building->SetNRoomsX(xRoomCount);
+    m_building->SetNRoomsY(yRoomCount);
+    m_building->SetNFloors(floorCount);
+
+    m_randomX = CreateObject<UniformRandomVariable>();
+    m_randomX->SetAttribute("Stream", IntegerValue(stream));
+    m_randomX->SetAttribute("Max", DoubleValue(boxSize));
+    m_randomX->SetAttribute("Min", DoubleValue(0.0));
+
+    m_randomY = CreateObject<UniformRandomVariable>();
+    m_randomY->SetAttribute("Stream", IntegerValue(stream + 1));
+    m_randomY->SetAttribute("Max", DoubleValue(boxSize));
+    m_randomY->SetAttribute("Min", DoubleValue(0.0));
+}
+
+void
+NetworkGymWifiScenario::InstallMobility(double boxSize, int64_t stream)
+{
+    uint32_t apCount = m_apNodes.GetN();
+    MobilityHelper mobility;
+    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+
+    // create a set of rooms in a building
+    uint32_t xRoomCount = apCount;
+    uint32_t yRoomCount = 1;
+    if (apCount >= 3)
+    {
+        xRoomCount = 2;
+        yRoomCount = 2;
+    }
+    CreateRooms(xRoomCount, yRoomCount, boxSize, stream);
+
+    for (uint32_t i = 0; i < apCount; i++)
+    {
+        double x = m_randomX->GetValue();
+        double y = m_randomY->GetValue();
+        if (i == 1)
+        {
+            x = (boxSize / 2) + (boxSize);
+            y = (boxSize / 2);
+        }
+        if (i == 2)
+        {
+            x = (boxSize / 2);
+            y = (boxSize / 2) + (boxSize);
+        }
+        else if (i == 3)
+        {
+            x = (boxSize / 2) + (boxSize);
+            y = (boxSize / 2) + (boxSize);
+        }
+        positionAlloc->Add(Vector(x, y, 1.5));
+        if (m_verbosity > 0)
+        {
+            std::cout << "AP" << i << " " << x << "," << y << "\n";
+        }
+    }
+    // Set postion for STAs
+    for (uint32_t i = 0; i < m_staNodes.GetN(); i++)
+    {
+        double x = m_randomX->GetValue();
+        double y = m_randomY->GetValue();
+        uint32_t currentAp = m_bss[m_staNodes.Get(i)->GetId()];
+        if (currentAp == 1)
+        {
+            x = x + (boxSize);
+        }
+        if (currentAp == 2)
+        {
+            y = y + (boxSize);
+        }
+        else if (currentAp == 3)
+        {
+            x = x + (boxSize);
+            y = y + (boxSize);
+        }
+        positionAlloc->Add(Vector(x, y, 1.5));
+        if (m_verbosity > 0)
+        {
+            std::cout << "STA" << i << " " << x << "," << y << "\n";
+        }
+    }
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(m_wifiNodes);
+    BuildingsHelper::Install(m_wifiNodes);
+}
+
+void
+NetworkGymWifiScenario::InstallGridMobility(double boxSize, int64_t stream)
+{
+    uint32_t apCount = m_apNodes.GetN();
+    uint32_t columns = std::ceil(std::sqrt(apCount));
+    uint32_t rows = (apCount + columns - 1) / columns;
+    CreateRooms(columns, rows, boxSize, stream);
+
+    MobilityHelper mobility;
+    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    for (uint32_t i = 0; i < m_wifiNodes.GetN(); i++)
+    {
+        uint32_t bss = m_bss[m_wifiNodes.Get(i)->GetId()];
+        double x0 = (bss % columns) * boxSize;
+        double y0 = (bss / columns) * boxSize;
+        // the APs are at the center of their box, the STAs at random positions of it
+        bool isAp = i < apCount;
+        double x = x0 + (isAp ? boxSize / 2 : m_randomX->GetValue());
+        double y = y0 + (isAp ? boxSize / 2 : m_randomY->GetValue());
+        positionAlloc->Add(Vector(x, y, 1.5));
+        if (m_verbosity > 0)
+        {
+            std::cout << (isAp ? "AP" : "STA") << (isAp ? i : i - apCount) << " " << x << "," << y
+                      << "\n";
+        }
+    }
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(m_wifiNodes);
+    BuildingsHelper::Install(m_wifiNodes);
+}
+
+const NodeContainer&
+NetworkGymWifiScenario::GetApNodes() const
+{
+    return m_apNodes;
+}
+
+const NodeContainer&
+NetworkGymWifiScenario::GetStaNodes() const
+{
+    return m_staNodes;
+}
+
+const NodeContainer&
+NetworkGymWifiScenario::GetWifiNodes() const
+{
+    return m_wifiNodes;
+}
+
+const NetDeviceContainer&
+NetworkGymWifiScenario::GetApDevices() const
+{
+    return m_apDevices;
+}
+
+const NetDeviceContainer&
+NetworkGymWifiScenario::GetStaDevices() const
+{
+    return m_staDevices;
+}
+
+const NetDeviceContainer&
+NetworkGymWifiScenario::GetDevices() const
+{
+    return m_devices;
+}
+
+uint32_t
+NetworkGymWifiScenario::GetBss(uint32_t nodeId) const
+{
+    return m_bss[nodeId];
+}
+
+const NetworkGymWifiScenario::WifiHandles&
+NetworkGymWifiScenario::GetHandles(uint32_t nodeId) const
+{
+    if (nodeId >= m_handles.size() || !m_handles[nodeId].device)
+    {
+        NS_FATAL_ERROR("No Wi-Fi device on node " << nodeId);
+    }
+    return m_handles[nodeId];
+}
+
+const std::vector<uint32_t>&
+NetworkGymWifiScenario::GetBssNodes(uint32_t bss) const
+{
+    if (bss >= m_bssNodes.size())
+    {
+        NS_FATAL_ERROR("No BSS " << bss);
+    }
+    return m_bssNodes[bss];
+}
+
+uint64_t
+NetworkGymWifiScenario::GetPeakRssKb()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+    return usage.ru_maxrss; // kilobytes on Linux
+}
+
+void
+NetworkGymWifiScenario::ReportSetup() const
+{
+    auto setupMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - m_setupStart)
+                       .count();
+    std::cout << "Setup: " << m_wifiNodes.GetN() << " nodes, " << m_installCalls
+              << " device install calls, " << setupMs << " ms, peak RSS " << GetPeakRssKb() / 1024
+              << " MB\n";
+}
+
+NetworkGymTrafficType
+NetworkGymWifiScenario::GetTrafficType(uint32_t nodeId) const
+{
+    return nodeId < m_config.size() ? m_config[nodeId].trafficType : NETWORKGYM_TRAFFIC_NONE;
+}
+
+} // namespace ns3
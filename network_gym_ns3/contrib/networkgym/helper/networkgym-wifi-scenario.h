@@ -0,0 +1,220 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#ifndef NETWORKGYM_WIFI_SCENARIO_H
+#define NETWORKGYM_WIFI_SCENARIO_H
+
+#include "ns3/building.h"
+#include "ns3/net-device-container.h"
+#include "ns3/networkgym-node-config.h"
+#include "ns3/node-container.h"
+#include "ns3/obss-pd-algorithm.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/wifi-remote-station-manager.h"
+#include "ns3/yans-wifi-helper.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup networkgym
+ * \brief Topology of the multi-BSS Wi-Fi scenarios (obss, multi-bss).
+ *
+ * The scenario has one AP per BSS and the STAs are assigned to the BSSs round robin, i.e., STA i
+ * belongs to BSS i % (number of APs). The APs are created first, so the node IDs are dense: APs
+ * take 0 to (number of APs - 1) and the STAs follow. Per node state is kept in vectors indexed by
+ * node ID.
+ *
+ * The node configuration is read with NetworkGymNodeConfigLoader, from a text or binary file.
+ *
+ * The Wi-Fi objects that the actions reconfigure are resolved once by InstallDevices, see GetHandles.
+ */
+class NetworkGymWifiScenario
+{
+  public:
+    /// The Wi-Fi objects of a node
+    struct WifiHandles
+    {
+        Ptr<WifiNetDevice> device;                    //!< the Wi-Fi device
+        Ptr<WifiPhy> phy;                             //!< the PHY of the device
+        Ptr<ObssPdAlgorithm> obssPdAlgorithm;         //!< null if the HE PHY has none
+        Ptr<WifiRemoteStationManager> stationManager; //!< the remote station manager
+    };
+
+    NetworkGymWifiScenario();
+
+    /**
+     * Split a CSV line. Quoted fields may contain the delimiter, "" is an escaped quote.
+     * \param source the line
+     * \param delimiter the field delimiter
+     * \return the fields
+     */
+    static std::vector<std::string> CsvSplit(const std::string& source, char delimiter);
+
+    /**
+     * \param filename the node configuration file, in the text or the binary form
+     */
+    void ReadConfigFile(const std::string& filename);
+
+    /**
+     * \param configs the configuration of each node, indexed by node ID
+     */
+    void SetNodeConfigs(std::vector<NetworkGymNodeConfig> configs);
+
+    /**
+     * \param verbosity 0 disables the per node output of the topology, e.g., the MAC addresses
+     *        and positions, larger values print it
+     */
+    void SetVerbosity(uint32_t verbosity);
+
+    /**
+     * Add the propagation loss model of the scenario to a channel.
+     * \param channel the channel
+     * \param frequency the operating band in GHz: 2.4, 5 or 6
+     * \param model "log", "tgax" or "fixed"
+     */
+    static void AddPropagationLoss(YansWifiChannelHelper& channel,
+                                   double frequency,
+                                   const std::string& model);
+
+    /**
+     * \param apCount the number of APs, i.e., of BSSs
+     * \param staCount the number of STAs
+     */
+    void CreateNodes(uint32_t apCount, uint32_t staCount);
+
+    /**
+     * Install one Wi-Fi device per node with the CCA sensitivity, the TX power and the channel of
+     * the node configuration. The BSS of AP i is "BSS-i". The STAs of a BSS with the same
+     * configuration are installed in one call, so the number of calls grows with the number of
+     * distinct configurations rather than of nodes. The devices are kept in node ID order. The
+     * handles of the nodes are resolved after the install.
+     *
+     * \param wifi the Wi-Fi helper
+     * \param phy the PHY helper, its channel must be set
+     * \param setBssColor whether to set the HE BSS color of BSS i to i + 1
+     */
+    void InstallDevices(WifiHelper& wifi, YansWifiPhyHelper& phy, bool setBssColor);
+
+    /**
+     * \param maxAmpduSize the maximum A-MPDU size of every access category, in bytes
+     */
+    void SetMaxAmpduSize(uint32_t maxAmpduSize);
+
+    /**
+     * Place the BSSs in the rooms of a building, one box per BSS, and install constant position
+     * mobility. APs 1 to 3 are at the center of their boxes and the STAs of BSSs 0 to 3 at random
+     * positions of the box of their BSS; the other nodes are at random positions of box 0.
+     *
+     * \param boxSize the size of a box, in meters
+     * \param stream the random stream of the x coordinates, stream + 1 is used for y
+     */
+    void InstallMobility(double boxSize, int64_t stream);
+
+    /**
+     * Place the BSSs on a grid of boxes, as square as possible, in a building with one room per
+     * box, and install constant position mobility. Each AP is at the center of the box of its
+     * BSS and its STAs at random positions of the box. Unlike InstallMobility, any number of APs
+     * is supported.
+     *
+     * \param boxSize the size of a box, in meters
+     * \param stream the random stream of the x coordinates, stream + 1 is used for y
+     */
+    void InstallGridMobility(double boxSize, int64_t stream);
+
+    /**
+     * Print the number of nodes and device install calls, the time since the scenario was
+     * created and the peak RSS of the process, to track the setup cost of large topologies.
+     */
+    void ReportSetup() const;
+
+    /// \return the peak resident set size of the process in kilobytes, 0 if unknown
+    static uint64_t GetPeakRssKb();
+
+    /// \return the APs
+    const NodeContainer& GetApNodes() const;
+    /// \return the STAs
+    const NodeContainer& GetStaNodes() const;
+    /// \return the APs followed by the STAs
+    const NodeContainer& GetWifiNodes() const;
+    /// \return the AP devices
+    const NetDeviceContainer& GetApDevices() const;
+    /// \return the STA devices
+    const NetDeviceContainer& GetStaDevices() const;
+    /// \return the AP devices followed by the STA devices
+    const NetDeviceContainer& GetDevices() const;
+
+    /**
+     * \param nodeId the node ID
+     * \return the BSS index of the node
+     */
+    uint32_t GetBss(uint32_t nodeId) const;
+
+    /**
+     * \param nodeId the node ID
+     * \return the cached Wi-Fi objects of the node
+     */
+    const WifiHandles& GetHandles(uint32_t nodeId) const;
+
+    /**
+     * \param bss the BSS index
+     * \return the IDs of the AP and the STAs of the BSS, in increasing order
+     */
+    const std::vector<uint32_t>& GetBssNodes(uint32_t bss) const;
+
+    /**
+     * \param nodeId the node ID
+     * \return the traffic type in the node configuration, none if the node is not configured
+     */
+    NetworkGymTrafficType GetTrafficType(uint32_t nodeId) const;
+
+  private:
+    /**
+     * Create the building and the random position streams of the boxes.
+     * \param xRoomCount the number of boxes along x
+     * \param yRoomCount the number of boxes along y
+     * \param boxSize the size of a box, in meters
+     * \param stream the random stream of the x coordinates, stream + 1 is used for y
+     */
+    void CreateRooms(uint32_t xRoomCount, uint32_t yRoomCount, double boxSize, int64_t stream);
+
+    /**
+     * Set the PHY attributes of the node configuration.
+     * \param phy the PHY helper
+     * \param nodeId the node ID
+     */
+    void SetPhyConfig(YansWifiPhyHelper& phy, uint32_t nodeId) const;
+
+    NodeContainer m_apNodes;          //!< APs
+    NodeContainer m_staNodes;         //!< STAs
+    NodeContainer m_wifiNodes;        //!< APs followed by STAs
+    NetDeviceContainer m_apDevices;   //!< AP devices
+    NetDeviceContainer m_staDevices;  //!< STA devices
+    NetDeviceContainer m_devices;     //!< AP devices followed by STA devices
+    Ptr<Building> m_building;         //!< building of the boxes
+    Ptr<UniformRandomVariable> m_randomX; //!< x coordinate in a box
+    Ptr<UniformRandomVariable> m_randomY; //!< y coordinate in a box
+    uint32_t m_verbosity;                 //!< per node output if not 0
+    uint32_t m_installCalls;              //!< WifiHelper::Install calls of InstallDevices
+    std::chrono::steady_clock::time_point m_setupStart; //!< creation of the scenario
+
+    // Per node state, indexed by node ID
+    std::vector<NetworkGymNodeConfig> m_config; //!< node configuration, read once
+    std::vector<uint32_t> m_bss;                //!< BSS index
+    std::vector<WifiHandles> m_handles;         //!< Wi-Fi objects, resolved by InstallDevices
+
+    std::vector<std::vector<uint32_t>> m_bssNodes; //!< node IDs, indexed by BSS
+};
+
+} // namespace ns3
+
+#endif /* NETWORKGYM_WIFI_SCENARIO_H */
@@ -0,0 +1,187 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#include "networkgym-worker-pool.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NetworkGymWorkerPool");
+
+NetworkGymWorkerPool::NetworkGymWorkerPool()
+    : m_nThreads(1),
+      m_grainSize(256),
+      m_builders(1),
+      m_generation(0),
+      m_pending(0),
+      m_activeThreads(1),
+      m_rows(0),
+      m_callback(nullptr),
+      m_stopping(false)
+{
+}
+
+NetworkGymWorkerPool::~NetworkGymWorkerPool()
+{
+    Stop();
+}
+
+void
+NetworkGymWorkerPool::SetNThreads(uint32_t threads)
+{
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    Stop();
+    m_nThreads = threads;
+    m_builders.assign(threads, Builder());
+}
+
+uint32_t
+NetworkGymWorkerPool::GetNThreads() const
+{
+    return m_nThreads;
+}
+
+void
+NetworkGymWorkerPool::SetGrainSize(uint32_t rows)
+{
+    m_grainSize = std::max(1u, rows);
+}
+
+void
+NetworkGymWorkerPool::Fill(uint32_t n,
+                           const RangeCallback& fn,
+                           std::vector<uint64_t>& ids,
+                           std::vector<double>& values,
+                           uint32_t rowCost)
+{
+    uint64_t cost = static_cast<uint64_t>(n) * rowCost;
+    uint32_t activeThreads =
+        std::max<uint64_t>(1, std::min<uint64_t>(GetNThreads(), cost / m_grainSize));
+    for (uint32_t worker = 0; worker < activeThreads; ++worker)
+    {
+        m_builders[worker].ids.clear();
+        m_builders[worker].values.clear();
+    }
+
+    if (activeThreads == 1)
+    {
+        fn(0, n, m_builders[0]);
+    }
+    else
+    {
+        Start();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_rows = n;
+            m_callback = &fn;
+            m_activeThreads = activeThreads;
+            m_pending = activeThreads - 1;
+            ++m_generation;
+        }
+        m_startCv.notify_all();
+        RunRange(0);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCv.wait(lock, [this] { return m_pending == 0; });
+        m_callback = nullptr;
+    }
+
+    // Concatenate in the range order, the first builder is moved if it is the only one
+    if (activeThreads == 1)
+    {
+        ids.swap(m_builders[0].ids);
+        values.swap(m_builders[0].values);
+        return;
+    }
+    size_t size = 0;
+    for (uint32_t worker = 0; worker < activeThreads; ++worker)
+    {
+        size += m_builders[worker].ids.size();
+    }
+    ids.clear();
+    values.clear();
+    ids.reserve(size);
+    values.reserve(size);
+    for (uint32_t worker = 0; worker < activeThreads; ++worker)
+    {
+        const Builder& builder = m_builders[worker];
+        ids.insert(ids.end(), builder.ids.begin(), builder.ids.end());
+        values.insert(values.end(), builder.values.begin(), builder.values.end());
+    }
+}
+
+void
+NetworkGymWorkerPool::RunRange(uint32_t worker)
+{
+    uint32_t first = static_cast<uint64_t>(m_rows) * worker / m_activeThreads;
+    uint32_t last = static_cast<uint64_t>(m_rows) * (worker + 1) / m_activeThreads;
+    (*m_callback)(first, last, m_builders[worker]);
+}
+
+void
+NetworkGymWorkerPool::Run(uint32_t worker)
+{
+    uint64_t generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_startCv.wait(lock, [&] { return m_stopping || m_generation != generation; });
+            if (m_stopping)
+            {
+                return;
+            }
+            generation = m_generation;
+            if (worker >= m_activeThreads)
+            {
+                continue; // a small loop that does not need this thread
+            }
+        }
+        RunRange(worker);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_pending;
+        }
+        m_doneCv.notify_one();
+    }
+}
+
+void
+NetworkGymWorkerPool::Start()
+{
+    if (!m_threads.empty())
+    {
+        return;
+    }
+    m_stopping = false;
+    for (uint32_t worker = 1; worker < m_nThreads; ++worker)
+    {
+        m_threads.emplace_back(&NetworkGymWorkerPool::Run, this, worker);
+    }
+    NS_LOG_INFO("Measurement worker threads: " << m_nThreads);
+}
+
+void
+NetworkGymWorkerPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_startCv.notify_all();
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+    m_threads.clear();
+}
+
+} // namespace ns3
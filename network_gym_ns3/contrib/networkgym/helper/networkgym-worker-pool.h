@@ -0,0 +1,133 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#ifndef NETWORKGYM_WORKER_POOL_H
+#define NETWORKGYM_WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup networkgym
+ * \brief Threads that split the per-row loops of a measurement across cores.
+ *
+ * The rows [0, n) are split into one contiguous range per thread, the simulator thread
+ * takes the first range and waits for the others. Each thread appends to its own Builder,
+ * and the builders are concatenated in the range order, so the result equals a serial loop.
+ *
+ * The threads are started by the first call that needs them, i.e., after the forks of
+ * NetworkGymReplicaHelper and of the "fork_episodes" mode, which happen before the first
+ * measurement.
+ *
+ * The ranges run concurrently with each other but not with the simulation. They may only
+ * read plain data, e.g., vectors filled before the call or NetworkGymRxPowerHelper after
+ * Snapshot, which computes the stale RX powers in the ranges. Ns-3 objects must not be
+ * touched: the reference counts of Ptr are not atomic, and most models mutate state when
+ * they are queried.
+ */
+class NetworkGymWorkerPool
+{
+  public:
+    /// The ids and values appended by one thread
+    struct Builder
+    {
+        std::vector<uint64_t> ids;  //!< ids in the append order
+        std::vector<double> values; //!< one value per id
+
+        /**
+         * \param id the id
+         * \param value the value
+         */
+        void Append(uint64_t id, double value)
+        {
+            ids.push_back(id);
+            values.push_back(value);
+        }
+    };
+
+    /// Callback of a range of rows: first row, last row (exclusive) and the builder of the thread
+    typedef std::function<void(uint32_t, uint32_t, Builder&)> RangeCallback;
+
+    NetworkGymWorkerPool();
+    ~NetworkGymWorkerPool();
+
+    NetworkGymWorkerPool(const NetworkGymWorkerPool&) = delete;
+    NetworkGymWorkerPool& operator=(const NetworkGymWorkerPool&) = delete;
+
+    /**
+     * \param threads the number of threads including the simulator thread, 0 uses one per
+     *        core, 1 (the default) runs the loops serially without any thread
+     */
+    void SetNThreads(uint32_t threads);
+
+    /// \return the number of threads including the simulator thread
+    uint32_t GetNThreads() const;
+
+    /**
+     * \param rows the minimum number of rows (of cost 1) per thread, smaller loops use fewer
+     *        threads
+     */
+    void SetGrainSize(uint32_t rows);
+
+    /**
+     * Call fn for one range of rows per thread, then replace ids and values with the
+     * concatenation of the builders.
+     *
+     * \param n the number of rows
+     * \param fn the callback of a range
+     * \param ids the merged ids
+     * \param values the merged values
+     * \param rowCost the cost of a row relative to the grain size, e.g., the number of
+     *        columns of a matrix row
+     */
+    void Fill(uint32_t n,
+              const RangeCallback& fn,
+              std::vector<uint64_t>& ids,
+              std::vector<double>& values,
+              uint32_t rowCost = 1);
+
+  private:
+    /**
+     * The loop of a worker thread.
+     * \param worker the index of the thread, 1 to the number of threads - 1
+     */
+    void Run(uint32_t worker);
+
+    /**
+     * \param worker the index of the thread
+     */
+    void RunRange(uint32_t worker);
+
+    /// Start the worker threads if they are not running
+    void Start();
+
+    /// Stop and join the worker threads
+    void Stop();
+
+    uint32_t m_nThreads;                 //!< threads including the simulator thread
+    uint32_t m_grainSize;                //!< minimum rows per thread
+    std::vector<std::thread> m_threads;  //!< the threads except the simulator thread
+    std::vector<Builder> m_builders;     //!< one per thread, reused across calls
+    std::mutex m_mutex;                  //!< guards the fields below
+    std::condition_variable m_startCv;   //!< notifies the workers of a new call
+    std::condition_variable m_doneCv;    //!< notifies the simulator thread of a finished range
+    uint64_t m_generation;               //!< incremented by each call
+    uint32_t m_pending;                  //!< ranges that are not finished yet
+    uint32_t m_activeThreads;            //!< threads used by the current call
+    uint32_t m_rows;                     //!< rows of the current call
+    const RangeCallback* m_callback;     //!< callback of the current call
+    bool m_stopping;                     //!< the worker threads exit
+};
+
+} // namespace ns3
+
+#endif /* NETWORKGYM_WORKER_POOL_H */
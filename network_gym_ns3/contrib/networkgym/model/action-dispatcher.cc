@@ -0,0 +1,181 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "action-dispatcher.h"
+#include <algorithm>
+
+namespace ns3 {
+
+ActionDispatcher::ActionDispatcher ()
+{
+}
+
+ActionDispatcher::Target&
+ActionDispatcher::GetTarget (std::string_view sourceAndName)
+{
+  size_t pos = sourceAndName.find("::");
+  if (pos == std::string_view::npos)
+  {
+    NS_FATAL_ERROR("The action name should be in the format of source::name, but received: " << sourceAndName);
+  }
+  std::string_view source = sourceAndName.substr(0, pos);
+  std::string_view name = sourceAndName.substr(pos + 2);
+
+  auto sourceIt = m_targetMap.find(source);
+  if (sourceIt == m_targetMap.end())
+  {
+    sourceIt = m_targetMap.emplace(std::string(source), NameMap()).first;
+  }
+  auto nameIt = sourceIt->second.find(name);
+  if (nameIt == sourceIt->second.end())
+  {
+    nameIt = sourceIt->second.emplace(std::string(name), m_targets.size()).first;
+    Target target;
+    target.sourceAndName = sourceAndName;
+    m_targets.push_back(std::move(target));
+  }
+  return m_targets[nameIt->second];
+}
+
+void
+ActionDispatcher::Add (std::string_view sourceAndName, uint64_t id, ActionCallback cb)
+{
+  Target& target = GetTarget(sourceAndName);
+  if (FindCallback(target, id) != INVALID_INDEX || target.bulkIndex != INVALID_INDEX)
+  {
+    NS_FATAL_ERROR("The callback with the same name and id already exists!");
+  }
+  uint32_t index = m_callbacks.size();
+  m_callbacks.push_back(cb);
+  if (id < MAX_DENSE_ID)
+  {
+    if (id >= target.denseIndex.size())
+    {
+      target.denseIndex.resize(id + 1, INVALID_INDEX);
+    }
+    target.denseIndex[id] = index;
+  }
+  else
+  {
+    target.sparseIndex[id] = index;
+  }
+}
+
+void
+ActionDispatcher::AddBulk (std::string_view sourceAndName, BulkActionCallback cb)
+{
+  Target& target = GetTarget(sourceAndName);
+  bool hasCallback = std::any_of(target.denseIndex.begin(), target.denseIndex.end(), [](uint32_t index) { return index != INVALID_INDEX; });
+  if (hasCallback || !target.sparseIndex.empty() || target.bulkIndex != INVALID_INDEX)
+  {
+    NS_FATAL_ERROR("A callback with the same name already exists: " << sourceAndName);
+  }
+  target.bulkIndex = m_bulkCallbacks.size();
+  m_bulkCallbacks.push_back(cb);
+}
+
+uint32_t
+ActionDispatcher::GetNCallbacks () const
+{
+  return m_callbacks.size() + m_bulkCallbacks.size();
+}
+
+uint32_t
+ActionDispatcher::FindCallback (const Target& target, uint64_t id) const
+{
+  if (id < MAX_DENSE_ID)
+  {
+    return id < target.denseIndex.size() ? target.denseIndex[id] : INVALID_INDEX;
+  }
+  auto it = target.sparseIndex.find(id);
+  return it == target.sparseIndex.end() ? INVALID_INDEX : it->second;
+}
+
+void
+ActionDispatcher::Dispatch (const json& actionList, double ts)
+{
+  if (actionList.is_array())
+  {
+    for (const auto& entry : actionList)
+    {
+      DispatchEntry(entry, ts);
+    }
+  }
+  else
+  {
+    //not an array. This is one action entry.
+    DispatchEntry(actionList, ts);
+  }
+}
+
+void
+ActionDispatcher::DispatchEntry (const json& entry, double ts)
+{
+  const std::string& source = entry["source"].get_ref<const std::string&>();
+  const std::string& name = entry["name"].get_ref<const std::string&>();
+  auto sourceIt = m_targetMap.find(source);
+  if (sourceIt == m_targetMap.end())
+  {
+    NS_FATAL_ERROR("callback does not exits for the action_name: "<< source << "::" << name);
+  }
+  auto nameIt = sourceIt->second.find(name);
+  if (nameIt == sourceIt->second.end())
+  {
+    NS_FATAL_ERROR("callback does not exits for the action_name: "<< source << "::" << name);
+  }
+  if (ts != entry["ts"])
+  {
+    NS_FATAL_ERROR("the action ts:"<< entry["ts"] <<" does not equal the measurement ts:" << ts);
+  }
+
+  const Target& target = m_targets[nameIt->second];
+  const json& value = entry["value"];
+  if (target.bulkIndex != INVALID_INDEX)
+  {
+    if (!value.is_array())
+    {
+      m_bulkCallbacks[target.bulkIndex](json::array({entry["id"]}), json::array({value}));
+      return;
+    }
+    if (entry["id"].size() != value.size())
+    {
+      NS_FATAL_ERROR("The size of the id and value list is not the same!!!");
+    }
+    m_bulkCallbacks[target.bulkIndex](entry["id"], value);
+    return;
+  }
+  if (value.is_array())
+  {
+    //one value per id.
+    const json& ids = entry["id"];
+    if (ids.size() != value.size())
+    {
+      NS_FATAL_ERROR("The size of the id and value list is not the same!!!");
+    }
+    for (uint32_t i = 0; i < ids.size(); i++)
+    {
+      Invoke(target, ids[i], value[i]);
+    }
+  }
+  else
+  {
+    Invoke(target, entry["id"], value);
+  }
+}
+
+void
+ActionDispatcher::Invoke (const Target& target, const json& id, const json& value)
+{
+  uint32_t index = FindCallback(target, id.get<uint64_t>());
+  if (index == INVALID_INDEX)
+  {
+    NS_FATAL_ERROR("callback does not exits for the action_name: "<< target.sourceAndName << " and id:" << id);
+  }
+  m_callbacks[index](value);
+}
+
+}
@@ -0,0 +1,67 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef ACTION_DISPATCHER_H
+#define ACTION_DISPATCHER_H
+
+#include "ns3/core-module.h"
+#include "json.hpp"
+#include <string_view>
+#include <unordered_map>
+using json = nlohmann::json;
+namespace ns3 {
+
+/*
+Send the action list to the connected callbacks. The (source::name, id) of a callback is resolved once when it is added;
+dispatching an action entry costs one source and name lookup, one ts check and an integer lookup per id. A bulk
+callback receives the id and value lists of an entry in one call instead, e.g., to reconfigure many nodes at once.
+*/
+class ActionDispatcher
+{
+public:
+  typedef Callback<void, const json& > ActionCallback;
+  typedef Callback<void, const json&, const json& > BulkActionCallback; //the id list and the value list of an entry.
+
+  ActionDispatcher ();
+
+  void Add (std::string_view sourceAndName, uint64_t id, ActionCallback cb); //e.g., "Obss::Py2Cpp::TxPowerNew", the name is split at the first "::".
+  void AddBulk (std::string_view sourceAndName, BulkActionCallback cb); //receives every id of the name, an entry with a single id is passed as lists of one.
+  void Dispatch (const json& actionList, double ts); //actionList is one action entry or a list of entries, i.e., {"source", "name", "ts", "id", "value"}.
+  uint32_t GetNCallbacks () const;
+
+private:
+  struct StringHash
+  {
+    using is_transparent = void;
+    size_t operator() (std::string_view s) const { return std::hash<std::string_view>{} (s); }
+  };
+
+  static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+  static constexpr uint64_t MAX_DENSE_ID = 4096; //ids below this are looked up in a vector, others in a hash map.
+
+  struct Target
+  {
+    std::string sourceAndName;
+    std::vector<uint32_t> denseIndex; //id -> callback index
+    std::unordered_map<uint64_t, uint32_t> sparseIndex; //id -> callback index, for ids >= MAX_DENSE_ID
+    uint32_t bulkIndex = INVALID_INDEX; //index in m_bulkCallbacks, the per id callbacks are not used if set.
+  };
+  typedef std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> NameMap;
+
+  Target& GetTarget (std::string_view sourceAndName); //add the target if it does not exist yet.
+  void DispatchEntry (const json& entry, double ts);
+  uint32_t FindCallback (const Target& target, uint64_t id) const;
+  void Invoke (const Target& target, const json& id, const json& value);
+
+  std::unordered_map<std::string, NameMap, StringHash, std::equal_to<>> m_targetMap; //source -> name -> target index
+  std::vector<Target> m_targets;
+  std::vector<ActionCallback> m_callbacks; //dense, indexed by the callback index
+  std::vector<BulkActionCallback> m_bulkCallbacks;
+};
+
+}
+
+#endif /* ACTION_DISPATCHER_H */
@@ -0,0 +1,721 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#include "auto-mcs-wifi-manager.h"
+
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/wifi-phy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AutoMcsWifiManager");
+
+NS_OBJECT_ENSURE_REGISTERED(AutoMcsWifiManager);
+
+/**
+ * \brief hold per-remote-station state for the AutoMcs Wifi manager.
+ */
+struct AutoMcsWifiRemoteStation : public WifiRemoteStation
+{
+    double m_lastSnrObserved;            //!< SNR of most recently reported packet sent to the remote station
+    uint16_t m_lastChannelWidthObserved; //!< Channel width (in MHz) of most recently reported packet sent to the remote station
+    uint16_t m_lastNssObserved;          //!< Number of spatial streams of most recently reported packet sent to the remote station
+    double m_lastSnrCached;              //!< SNR most recently used to select a rate
+    uint8_t m_lastNss;                   //!< Number of spatial streams most recently used to the remote station
+    WifiMode m_lastMode;                 //!< Mode most recently used to the remote station
+    uint16_t m_lastChannelWidth;         //!< Channel width (in MHz) most recently used to the remote station
+};
+
+/// To avoid using the cache before a valid value has been cached
+static constexpr double CACHE_INITIAL_VALUE = -100;
+
+/// Bit positions of the fields of a threshold key
+static constexpr uint32_t KEY_MOD_CLASS_SHIFT = 40;
+static constexpr uint32_t KEY_MODE_SHIFT = 24;
+static constexpr uint32_t KEY_WIDTH_SHIFT = 8;
+
+/**
+ * \return the threshold tables of all managers, by PHY capabilities
+ */
+static std::map<std::string, std::shared_ptr<const std::vector<std::pair<uint64_t, double>>>>&
+GetSharedThresholds()
+{
+    static std::map<std::string, std::shared_ptr<const std::vector<std::pair<uint64_t, double>>>>
+        thresholds;
+    return thresholds;
+}
+
+TypeId
+AutoMcsWifiManager::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::AutoMcsWifiManager")
+            .SetParent<WifiRemoteStationManager>()
+            .SetGroupName("Wifi")
+            .AddConstructor<AutoMcsWifiManager>()
+            .AddAttribute("BerThreshold",
+                          "The maximum Bit Error Rate acceptable at any transmission mode",
+                          DoubleValue(1e-7),
+                          // This default value was modified
+                          MakeDoubleAccessor(&AutoMcsWifiManager::m_ber),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("autoMCS",
+                          "If enabled, select the best MCS for each STA-AP pair given the SNR.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&AutoMcsWifiManager::m_autoMCS),
+                          MakeBooleanChecker())
+            .AddTraceSource("Rate",
+                            "Traced value for rate changes (b/s)",
+                            MakeTraceSourceAccessor(&AutoMcsWifiManager::m_currentRate),
+                            "ns3::TracedValueCallback::Uint64");
+    return tid;
+}
+
+AutoMcsWifiManager::AutoMcsWifiManager()
+    : m_currentRate(0),
+      m_mcsSum(0),
+      m_mcsCount(0),
+      m_meanMcs(-1)
+{
+}
+
+AutoMcsWifiManager::~AutoMcsWifiManager()
+{
+}
+
+void
+AutoMcsWifiManager::SetupPhy(const Ptr<WifiPhy> phy)
+{
+    WifiRemoteStationManager::SetupPhy(phy);
+}
+
+void
+AutoMcsWifiManager::DoInitialize()
+{
+    BuildSnrThresholds();
+    m_rtsMode = WifiMode("OfdmRate6Mbps");
+    WifiRemoteStationManager::DoInitialize();
+}
+
+WifiRemoteStation*
+AutoMcsWifiManager::DoCreateStation() const
+{
+    auto* station = new AutoMcsWifiRemoteStation();
+    Reset(station);
+    return station;
+}
+
+void
+AutoMcsWifiManager::DoReportRxOk(WifiRemoteStation* station, double rxSnr, WifiMode txMode)
+{
+}
+
+void
+AutoMcsWifiManager::DoReportRtsFailed(WifiRemoteStation* station)
+{
+}
+
+void
+AutoMcsWifiManager::DoReportDataFailed(WifiRemoteStation* station)
+{
+}
+
+void
+AutoMcsWifiManager::DoReportRtsOk(WifiRemoteStation* st,
+                                  double ctsSnr,
+                                  WifiMode ctsMode,
+                                  double rtsSnr)
+{
+    auto* station = static_cast<AutoMcsWifiRemoteStation*>(st);
+    station->m_lastSnrObserved = rtsSnr;
+    station->m_lastChannelWidthObserved =
+        GetPhy()->GetChannelWidth() >= 40 ? 20 : GetPhy()->GetChannelWidth();
+    station->m_lastNssObserved = 1;
+}
+
+void
+AutoMcsWifiManager::DoReportDataOk(WifiRemoteStation* st,
+                                   double ackSnr,
+                                   WifiMode ackMode,
+                                   double dataSnr,
+                                   MHz_u dataChannelWidth,
+                                   uint8_t dataNss)
+{
+    auto* station = static_cast<AutoMcsWifiRemoteStation*>(st);
+    if (dataSnr == 0)
+    {
+        NS_LOG_WARN("DataSnr reported to be zero; not saving this report.");
+        return;
+    }
+    station->m_lastSnrObserved = dataSnr;
+    station->m_lastChannelWidthObserved = dataChannelWidth;
+    station->m_lastNssObserved = dataNss;
+    if (station->m_lastMode != GetDefaultMode())
+    {
+        m_mcsSum += station->m_lastMode.GetMcsValue();
+        m_mcsCount++;
+    }
+}
+
+void
+AutoMcsWifiManager::DoReportAmpduTxStatus(WifiRemoteStation* st,
+                                          uint16_t nSuccessfulMpdus,
+                                          uint16_t nFailedMpdus,
+                                          double rxSnr,
+                                          double dataSnr,
+                                          MHz_u dataChannelWidth,
+                                          uint8_t dataNss)
+{
+    auto* station = static_cast<AutoMcsWifiRemoteStation*>(st);
+    if (dataSnr == 0)
+    {
+        NS_LOG_WARN("DataSnr reported to be zero; not saving this report.");
+        return;
+    }
+    if (nSuccessfulMpdus > 0)
+    {
+        m_mcsSum += static_cast<uint64_t>(station->m_lastMode.GetMcsValue()) * nSuccessfulMpdus;
+        m_mcsCount += nSuccessfulMpdus;
+    }
+    station->m_lastSnrObserved = dataSnr;
+    station->m_lastChannelWidthObserved = dataChannelWidth;
+    station->m_lastNssObserved = dataNss;
+}
+
+void
+AutoMcsWifiManager::DoReportFinalRtsFailed(WifiRemoteStation* station)
+{
+    Reset(station);
+}
+
+void
+AutoMcsWifiManager::DoReportFinalDataFailed(WifiRemoteStation* station)
+{
+    Reset(station);
+}
+
+WifiTxVector
+AutoMcsWifiManager::DoGetDataTxVector(WifiRemoteStation* st, MHz_u allowedWidth)
+{
+    auto* station = static_cast<AutoMcsWifiRemoteStation*>(st);
+    // We search within the Supported rate set the mode with the
+    // highest data rate for which the SNR threshold is smaller than m_lastSnr
+    // to ensure correct packet delivery.
+    WifiMode maxMode = GetDefaultModeForSta(st);
+    WifiTxVector txVector;
+    WifiMode mode;
+    uint64_t bestRate = 0;
+    uint8_t selectedNss = 1;
+    uint16_t guardInterval;
+    uint16_t channelWidth = std::min(GetChannelWidth(station), allowedWidth);
+    txVector.SetChannelWidth(channelWidth);
+
+    if ((Simulator::Now().GetSeconds() < 10))
+    {
+        if ((station->m_lastSnrCached != CACHE_INITIAL_VALUE) &&
+            (station->m_lastSnrObserved == station->m_lastSnrCached) &&
+            (channelWidth == station->m_lastChannelWidth))
+        {
+            // SNR has not changed, so skip the search and use the last mode selected
+            maxMode = station->m_lastMode;
+            selectedNss = station->m_lastNss;
+            NS_LOG_DEBUG(
+                "Using cached mode = " << maxMode.GetUniqueName() << " last snr observed "
+                << station->m_lastSnrObserved << " cached "
+                << station->m_lastSnrCached << " channel width "
+                << station->m_lastChannelWidth << " nss "
+                << +selectedNss);
+        }
+
+        else
+        {
+            if (GetHtSupported() && GetHtSupported(st))
+            {
+                for (uint8_t i = 0; i < GetNMcsSupported(station); i++)
+                {
+                    mode = GetMcsSupported(station, i);
+                    txVector.SetMode(mode);
+                    if (mode.GetModulationClass() == WIFI_MOD_CLASS_HT)
+                    {
+                        guardInterval = static_cast<uint16_t>(
+                            std::max(GetShortGuardIntervalSupported(station) ? 400 : 800,
+                                     GetShortGuardIntervalSupported() ? 400 : 800));
+                        txVector.SetGuardInterval(NanoSeconds(guardInterval));
+                        // If the node and peer are both VHT capable, only search VHT modes
+                        if (GetVhtSupported() && GetVhtSupported(station))
+                        {
+                            continue;
+                        }
+                        // If the node and peer are both HE capable, only search HE modes
+                        if (GetHeSupported() && GetHeSupported(station))
+                        {
+                            continue;
+                        }
+                        // Derive NSS from the MCS index. There is a different mode for each
+                        // possible NSS value.
+                        uint8_t nss = (mode.GetMcsValue() / 8) + 1;
+                        txVector.SetNss(nss);
+                        if (!txVector.IsValid() || nss > std::min(
+                                GetMaxNumberOfTransmitStreams(),
+                                GetNumberOfSupportedStreams(st)))
+                        {
+                            NS_LOG_DEBUG(
+                                "Skipping mode " << mode.GetUniqueName() << " nss " << +nss
+                                << " width "
+                                << txVector.GetChannelWidth());
+                            continue;
+                        }
+                        double threshold = GetSnrThreshold(txVector);
+                        uint64_t dataRate = mode.GetDataRate(txVector.GetChannelWidth(),
+                                                             txVector.GetGuardInterval(),
+                                                             nss);
+                        NS_LOG_DEBUG("Testing mode " << mode.GetUniqueName() << " data rate "
+                            << dataRate << " threshold " << threshold
+                            << " last snr observed "
+                            << station->m_lastSnrObserved << " cached "
+                            << station->m_lastSnrCached);
+                        double snr = GetLastObservedSnr(station, channelWidth, nss);
+                        if (dataRate > bestRate && threshold < snr)
+                        {
+                            NS_LOG_DEBUG("Candidate mode = "
+                                << mode.GetUniqueName() << " data rate " << dataRate
+                                << " threshold " << threshold << " channel width "
+                                << channelWidth << " snr " << snr);
+                            bestRate = dataRate;
+                            maxMode = mode;
+                            selectedNss = nss;
+                        }
+                    }
+                    else if (mode.GetModulationClass() == WIFI_MOD_CLASS_VHT)
+                    {
+                        guardInterval = static_cast<uint16_t>(
+                            std::max(GetShortGuardIntervalSupported(station) ? 400 : 800,
+                                     GetShortGuardIntervalSupported() ? 400 : 800));
+                        txVector.SetGuardInterval(NanoSeconds(guardInterval));
+                        // If the node and peer are both HE capable, only search HE modes
+                        if (GetHeSupported() && GetHeSupported(station))
+                        {
+                            continue;
+                        }
+                        // If the node and peer are not both VHT capable, only search HT modes
+                        if (!GetVhtSupported() || !GetVhtSupported(station))
+                        {
+                            continue;
+                        }
+                        for (uint8_t nss = 1; nss <= std::min(GetMaxNumberOfTransmitStreams(),
+                                                  GetNumberOfSupportedStreams(station));
+                             nss++)
+                        {
+                            txVector.SetNss(nss);
+                            if (!txVector.IsValid())
+                            {
+                                NS_LOG_DEBUG("Skipping mode " << mode.GetUniqueName() << " nss "
+                                    << +nss << " width "
+                                    << txVector.GetChannelWidth());
+                                continue;
+                            }
+                            double threshold = GetSnrThreshold(txVector);
+                            uint64_t dataRate = mode.GetDataRate(txVector.GetChannelWidth(),
+                                txVector.GetGuardInterval(),
+                                nss);
+                            NS_LOG_DEBUG("Testing mode = "
+                                << mode.GetUniqueName() << " data rate " << dataRate
+                                << " threshold " << threshold << " last snr observed "
+                                << station->m_lastSnrObserved << " cached "
+                                << station->m_lastSnrCached);
+                            double snr = GetLastObservedSnr(station, channelWidth, nss);
+                            if (dataRate > bestRate && threshold < snr)
+                            {
+                                NS_LOG_DEBUG("Candidate mode = " << mode.GetUniqueName()
+                                    << " data rate " << dataRate
+                                    << " channel width "
+                                    << channelWidth << " snr " << snr);
+                                bestRate = dataRate;
+                                maxMode = mode;
+                                selectedNss = nss;
+                            }
+                        }
+                    }
+                    else // HE
+                    {
+                        guardInterval = std::max(GetGuardInterval(station).ToInteger(Time::NS),
+                                                 GetGuardInterval().ToInteger(Time::NS));
+                        txVector.SetGuardInterval(NanoSeconds(guardInterval));
+                        // If the node and peer are not both HE capable, only search (V)HT modes
+                        if (!GetHeSupported() || !GetHeSupported(station))
+                        {
+                            continue;
+                        }
+                        for (uint8_t nss = 1; nss <= std::min(GetMaxNumberOfTransmitStreams(),
+                                                  GetNumberOfSupportedStreams(station));
+                             nss++)
+                        {
+                            txVector.SetNss(nss);
+                            if (!txVector.IsValid())
+                            {
+                                NS_LOG_DEBUG("Skipping mode " << mode.GetUniqueName() << " nss "
+                                    << +nss << " width "
+                                    << +txVector.GetChannelWidth());
+                                continue;
+                            }
+                            double threshold = GetSnrThreshold(txVector);
+                            uint64_t dataRate = mode.GetDataRate(txVector.GetChannelWidth(),
+                                txVector.GetGuardInterval(),
+                                nss);
+                            NS_LOG_DEBUG("Testing mode = "
+                                << mode.GetUniqueName() << " data rate " << dataRate
+                                << " threshold " << threshold << " last snr observed "
+                                << station->m_lastSnrObserved << " cached "
+                                << station->m_lastSnrCached);
+                            double snr = GetLastObservedSnr(station, channelWidth, nss);
+                            if (dataRate > bestRate && threshold < snr)
+                            {
+                                NS_LOG_DEBUG("Candidate mode = "
+                                    << mode.GetUniqueName() << " data rate " << dataRate
+                                    << " threshold " << threshold << " channel width "
+                                    << channelWidth << " snr " << snr);
+                                bestRate = dataRate;
+                                maxMode = mode;
+                                selectedNss = nss;
+                            }
+                        }
+                    }
+                }
+            }
+            else
+            {
+                // Non-HT selection
+                selectedNss = 1;
+                for (uint8_t i = 0; i < GetNSupported(station); i++)
+                {
+                    mode = GetSupported(station, i);
+                    txVector.SetMode(mode);
+                    txVector.SetNss(selectedNss);
+                    uint16_t width = GetChannelWidthForNonHtMode(mode);
+                    txVector.SetChannelWidth(width);
+                    double threshold = GetSnrThreshold(txVector);
+                    uint64_t dataRate = mode.GetDataRate(txVector.GetChannelWidth(),
+                                                         txVector.GetGuardInterval(),
+                                                         txVector.GetNss());
+                    NS_LOG_DEBUG("mode = " << mode.GetUniqueName() << " threshold " << threshold
+                        << " last snr observed " << station->m_lastSnrObserved);
+                    double snr = GetLastObservedSnr(station, width, 1);
+                    if (dataRate > bestRate && threshold < snr)
+                    {
+                        NS_LOG_DEBUG(
+                            "Candidate mode = " << mode.GetUniqueName() << " data rate "
+                            << dataRate << " threshold " << threshold
+                            << " snr " << snr);
+                        bestRate = dataRate;
+                        maxMode = mode;
+                    }
+                }
+            }
+            NS_LOG_DEBUG("Updating cached values for station to "
+                << maxMode.GetUniqueName() << " snr " << station->m_lastSnrObserved);
+            station->m_lastSnrCached = station->m_lastSnrObserved;
+            station->m_lastMode = maxMode;
+            station->m_lastNss = selectedNss;
+        }
+    }
+    else
+    {
+        // Keep the default mode until an MPDU was acknowledged, the mean is not defined yet
+        if (m_mcsCount > 0)
+        {
+            int meanMcs = static_cast<int>(
+                std::ceil(static_cast<double>(m_mcsSum) / static_cast<double>(m_mcsCount)));
+            // The rounded mean rarely changes, look the mode up by name only when it does
+            if (meanMcs != m_meanMcs)
+            {
+                m_meanMcs = meanMcs;
+                m_meanMcsMode = WifiMode("HeMcs" + std::to_string(meanMcs));
+            }
+            maxMode = m_meanMcsMode;
+        }
+    }
+    NS_LOG_DEBUG("Found maxMode: " << maxMode << " channelWidth: " << channelWidth
+        << " nss: " << +selectedNss);
+    station->m_lastChannelWidth = channelWidth;
+    if (maxMode.GetModulationClass() == WIFI_MOD_CLASS_HE)
+    {
+        guardInterval = std::max(GetGuardInterval(station).ToInteger(Time::NS),
+                                 GetGuardInterval().ToInteger(Time::NS));
+    }
+    else if ((maxMode.GetModulationClass() == WIFI_MOD_CLASS_HT) ||
+             (maxMode.GetModulationClass() == WIFI_MOD_CLASS_VHT))
+    {
+        guardInterval =
+            static_cast<uint16_t>(std::max(GetShortGuardIntervalSupported(station) ? 400 : 800,
+                                           GetShortGuardIntervalSupported() ? 400 : 800));
+    }
+    else
+    {
+        guardInterval = 800;
+    }
+    WifiTxVector bestTxVector{
+        maxMode,
+        GetDefaultTxPowerLevel(),
+        GetPreambleForTransmission(maxMode.GetModulationClass(), GetShortPreambleEnabled()),
+        NanoSeconds(guardInterval),
+        GetNumberOfAntennas(),
+        selectedNss,
+        0,
+        GetPhy()->GetTxBandwidth(maxMode, channelWidth),
+        GetAggregation(station)};
+
+    uint64_t maxDataRate = maxMode.GetDataRate(bestTxVector);
+
+    if (m_currentRate != maxDataRate)
+    {
+        // std::cout << "New datarate: " << maxMode << std::endl;
+
+        m_currentRate = maxDataRate;
+    }
+
+    return bestTxVector;
+}
+
+WifiTxVector
+AutoMcsWifiManager::DoGetRtsTxVector(WifiRemoteStation* st)
+{
+    if (!m_autoMCS)
+    {
+        auto* station = static_cast<AutoMcsWifiRemoteStation*>(st);
+        // We search within the Basic rate set the mode with the highest
+        // SNR threshold possible which is smaller than m_lastSnr to
+        // ensure correct packet delivery.
+        double maxThreshold = 0.0;
+        WifiTxVector txVector;
+        WifiMode mode;
+        uint8_t nss = 1;
+        WifiMode maxMode = GetDefaultMode();
+        // RTS is sent in a non-HT frame
+        for (uint8_t i = 0; i < GetNBasicModes(); i++)
+        {
+            mode = GetBasicMode(i);
+            txVector.SetMode(mode);
+            txVector.SetNss(nss);
+            txVector.SetChannelWidth(GetChannelWidthForNonHtMode(mode));
+            double threshold = GetSnrThreshold(txVector);
+            if (threshold > maxThreshold && threshold < station->m_lastSnrObserved)
+            {
+                maxThreshold = threshold;
+                maxMode = mode;
+            }
+        }
+        return WifiTxVector(
+            maxMode,
+            GetDefaultTxPowerLevel(),
+            GetPreambleForTransmission(maxMode.GetModulationClass(), GetShortPreambleEnabled()),
+            NanoSeconds(800),
+            GetNumberOfAntennas(),
+            nss,
+            0,
+            GetChannelWidthForNonHtMode(maxMode),
+            GetAggregation(station));
+    }
+    else
+    {
+        return WifiTxVector(
+            m_rtsMode,
+            GetDefaultTxPowerLevel(),
+            GetPreambleForTransmission(m_rtsMode.GetModulationClass(), GetShortPreambleEnabled()),
+            GetGuardInterval(st),
+            1,
+            1,
+            0,
+            GetPhy()->GetTxBandwidth(m_rtsMode, GetChannelWidth(st)),
+            GetAggregation(st));
+    }
+}
+
+void
+AutoMcsWifiManager::Reset(WifiRemoteStation* station) const
+{
+    auto* st = static_cast<AutoMcsWifiRemoteStation*>(station);
+    st->m_lastSnrObserved = 0.0;
+    st->m_lastChannelWidthObserved = 0;
+    st->m_lastNssObserved = 1;
+    st->m_lastSnrCached = CACHE_INITIAL_VALUE;
+    st->m_lastMode = GetDefaultMode();
+    st->m_lastChannelWidth = 0;
+    st->m_lastNss = 1;
+}
+
+void
+AutoMcsWifiManager::BuildSnrThresholds()
+{
+    // Everything ComputeSnrThresholds depends on
+    std::ostringstream capabilities;
+    capabilities << GetPhy()->GetInstanceTypeId().GetName() << " " << GetPhy()->GetStandard() << " "
+                 << GetPhy()->GetPhyBand() << " " << GetPhy()->GetChannelWidth() << " "
+                 << +GetPhy()->GetMaxSupportedTxSpatialStreams() << " " << GetHtSupported() << " "
+                 << GetShortGuardIntervalSupported() << " "
+                 << GetGuardInterval().ToInteger(Time::NS) << " " << m_ber;
+
+    auto& shared = GetSharedThresholds()[capabilities.str()];
+    if (!shared)
+    {
+        NS_LOG_DEBUG("Building SNR thresholds for " << capabilities.str());
+        shared = std::make_shared<const Thresholds>(ComputeSnrThresholds());
+    }
+    m_thresholds = shared;
+}
+
+AutoMcsWifiManager::Thresholds
+AutoMcsWifiManager::ComputeSnrThresholds() const
+{
+    Thresholds thresholds;
+    WifiTxVector txVector;
+    uint8_t nss = 1;
+    for (const auto& mode : GetPhy()->GetModeList())
+    {
+        txVector.SetChannelWidth(GetChannelWidthForNonHtMode(mode));
+        txVector.SetNss(nss);
+        txVector.SetMode(mode);
+        NS_LOG_DEBUG("Adding mode = " << mode.GetUniqueName());
+        thresholds.emplace_back(GetThresholdKey(txVector), GetPhy()->CalculateSnr(txVector, m_ber));
+    }
+    // Add all MCSes
+    if (GetHtSupported())
+    {
+        for (const auto& mode : GetPhy()->GetMcsList())
+        {
+            for (uint16_t j = 20; j <= GetPhy()->GetChannelWidth(); j *= 2)
+            {
+                txVector.SetChannelWidth(j);
+                if (mode.GetModulationClass() == WIFI_MOD_CLASS_HT)
+                {
+                    uint16_t guardInterval = GetShortGuardIntervalSupported() ? 400 : 800;
+                    txVector.SetGuardInterval(NanoSeconds(guardInterval));
+                    // derive NSS from the MCS index
+                    nss = (mode.GetMcsValue() / 8) + 1;
+                    NS_LOG_DEBUG("Adding mode = " << mode.GetUniqueName() << " channel width " << j
+                                                  << " nss " << +nss << " GI " << guardInterval);
+                    txVector.SetNss(nss);
+                    txVector.SetMode(mode);
+                    thresholds.emplace_back(GetThresholdKey(txVector),
+                                            GetPhy()->CalculateSnr(txVector, m_ber));
+                }
+                else // VHT or HE
+                {
+                    uint16_t guardInterval;
+                    if (mode.GetModulationClass() == WIFI_MOD_CLASS_VHT)
+                    {
+                        guardInterval = GetShortGuardIntervalSupported() ? 400 : 800;
+                    }
+                    else
+                    {
+                        guardInterval = GetGuardInterval().ToInteger(Time::NS);
+                    }
+                    txVector.SetGuardInterval(NanoSeconds(guardInterval));
+                    for (uint8_t k = 1; k <= GetPhy()->GetMaxSupportedTxSpatialStreams(); k++)
+                    {
+                        if (mode.IsAllowed(j, k))
+                        {
+                            NS_LOG_DEBUG("Adding mode = " << mode.GetUniqueName() << " channel width "
+                                                          << j << " nss " << +k << " GI "
+                                                          << guardInterval);
+                            txVector.SetNss(k);
+                            txVector.SetMode(mode);
+                            thresholds.emplace_back(GetThresholdKey(txVector),
+                                                    GetPhy()->CalculateSnr(txVector, m_ber));
+                        }
+                        else
+                        {
+                            NS_LOG_DEBUG("Mode = " << mode.GetUniqueName() << " disallowed");
+                        }
+                    }
+                }
+            }
+        }
+    }
+    // Stable, such that the first threshold of a key wins, as in a linear search
+    std::stable_sort(thresholds.begin(),
+                     thresholds.end(),
+                     [](const std::pair<uint64_t, double>& a, const std::pair<uint64_t, double>& b) {
+                         return a.first < b.first;
+                     });
+    return thresholds;
+}
+
+double
+AutoMcsWifiManager::GetSnrThreshold(const WifiTxVector& txVector)
+{
+    uint64_t key = GetThresholdKey(txVector);
+    auto compare = [](const std::pair<uint64_t, double>& p, uint64_t k) { return p.first < k; };
+    auto it = std::lower_bound(m_thresholds->begin(), m_thresholds->end(), key, compare);
+    if (it == m_thresholds->end() || it->first != key)
+    {
+        // This means capabilities have changed in runtime, hence rebuild SNR thresholds
+        BuildSnrThresholds();
+        it = std::lower_bound(m_thresholds->begin(), m_thresholds->end(), key, compare);
+        NS_ASSERT_MSG(it != m_thresholds->end() && it->first == key, "SNR threshold not found");
+    }
+    return it->second;
+}
+
+uint64_t
+AutoMcsWifiManager::GetThresholdKey(const WifiTxVector& txVector)
+{
+    // The mode UID identifies the MCS within its modulation class, it is also defined for non-HT
+    // modes
+    WifiMode mode = txVector.GetMode();
+    return (static_cast<uint64_t>(mode.GetModulationClass()) << KEY_MOD_CLASS_SHIFT) |
+           (static_cast<uint64_t>(mode.GetUid()) << KEY_MODE_SHIFT) |
+           (static_cast<uint64_t>(txVector.GetChannelWidth()) << KEY_WIDTH_SHIFT) |
+           txVector.GetNss();
+}
+
+uint16_t
+AutoMcsWifiManager::GetChannelWidthForNonHtMode(WifiMode mode)
+{
+    NS_ASSERT(mode.GetModulationClass() != WIFI_MOD_CLASS_HT &&
+              mode.GetModulationClass() != WIFI_MOD_CLASS_VHT &&
+              mode.GetModulationClass() != WIFI_MOD_CLASS_HE);
+    if (mode.GetModulationClass() == WIFI_MOD_CLASS_DSSS ||
+        mode.GetModulationClass() == WIFI_MOD_CLASS_HR_DSSS)
+    {
+        return 22;
+    }
+    else
+    {
+        return 20;
+    }
+}
+
+double
+AutoMcsWifiManager::GetLastObservedSnr(const AutoMcsWifiRemoteStation* station,
+                                       uint16_t channelWidth,
+                                       uint8_t nss)
+{
+    double snr = station->m_lastSnrObserved;
+    if (channelWidth != station->m_lastChannelWidthObserved)
+    {
+        snr /= (static_cast<double>(channelWidth) / station->m_lastChannelWidthObserved);
+    }
+    if (nss != station->m_lastNssObserved)
+    {
+        snr /= (static_cast<double>(nss) / station->m_lastNssObserved);
+    }
+    NS_LOG_DEBUG("Last observed SNR is " << station->m_lastSnrObserved << " for channel width "
+                                         << station->m_lastChannelWidthObserved << " and nss "
+                                         << +station->m_lastNssObserved << "; computed SNR is "
+                                         << snr << " for channel width " << channelWidth
+                                         << " and nss " << +nss);
+    return snr;
+}
+
+} // namespace ns3
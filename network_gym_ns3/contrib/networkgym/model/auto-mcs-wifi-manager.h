@@ -0,0 +1,136 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#ifndef AUTO_MCS_WIFI_MANAGER_H
+#define AUTO_MCS_WIFI_MANAGER_H
+
+#include "ns3/traced-value.h"
+#include "ns3/wifi-remote-station-manager.h"
+
+#include <memory>
+#include <vector>
+
+namespace ns3
+{
+
+struct AutoMcsWifiRemoteStation;
+
+/**
+ * \ingroup networkgym
+ * \brief Ideal-like rate manager of the networkgym Wi-Fi scenarios.
+ *
+ * During the first 10 seconds the mode with the highest data rate whose SNR threshold is below
+ * the last observed SNR is selected. Afterwards, the HE MCS is fixed to the rounded up mean of
+ * the MCSs acknowledged so far.
+ *
+ * The SNR thresholds are kept in a table sorted by (modulation class, mode, channel width,
+ * NSS) and searched with a binary search. The table only depends on the PHY capabilities and
+ * the BER threshold, so it is built once and shared by all the managers with the same
+ * capabilities.
+ */
+class AutoMcsWifiManager : public WifiRemoteStationManager
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    AutoMcsWifiManager();
+    ~AutoMcsWifiManager() override;
+
+    void SetupPhy(const Ptr<WifiPhy> phy) override;
+
+  private:
+    /// (threshold key, minimum SNR) pairs sorted by key
+    typedef std::vector<std::pair<uint64_t, double>> Thresholds;
+
+    void DoInitialize() override;
+    WifiRemoteStation* DoCreateStation() const override;
+    void DoReportRxOk(WifiRemoteStation* station, double rxSnr, WifiMode txMode) override;
+    void DoReportRtsFailed(WifiRemoteStation* station) override;
+    void DoReportDataFailed(WifiRemoteStation* station) override;
+    void DoReportRtsOk(WifiRemoteStation* station,
+                       double ctsSnr,
+                       WifiMode ctsMode,
+                       double rtsSnr) override;
+    void DoReportDataOk(WifiRemoteStation* station,
+                        double ackSnr,
+                        WifiMode ackMode,
+                        double dataSnr,
+                        MHz_u dataChannelWidth,
+                        uint8_t dataNss) override;
+    void DoReportAmpduTxStatus(WifiRemoteStation* station,
+                               uint16_t nSuccessfulMpdus,
+                               uint16_t nFailedMpdus,
+                               double rxSnr,
+                               double dataSnr,
+                               MHz_u dataChannelWidth,
+                               uint8_t dataNss) override;
+    void DoReportFinalRtsFailed(WifiRemoteStation* station) override;
+    void DoReportFinalDataFailed(WifiRemoteStation* station) override;
+    WifiTxVector DoGetDataTxVector(WifiRemoteStation* station, MHz_u allowedWidth) override;
+    WifiTxVector DoGetRtsTxVector(WifiRemoteStation* station) override;
+
+    /**
+     * Reset the SNR observations and the cached mode of a station.
+     * \param station the station
+     */
+    void Reset(WifiRemoteStation* station) const;
+
+    /**
+     * Point m_thresholds to the shared table of the current PHY capabilities; the table is
+     * built if no other manager built it yet.
+     */
+    void BuildSnrThresholds();
+
+    /**
+     * Compute the SNR thresholds of every mode, channel width and NSS supported by the PHY.
+     * \return the thresholds, sorted by key
+     */
+    Thresholds ComputeSnrThresholds() const;
+
+    /**
+     * \param txVector the TX vector
+     * \return the minimum SNR of the TX vector
+     */
+    double GetSnrThreshold(const WifiTxVector& txVector);
+
+    /**
+     * \param txVector the TX vector
+     * \return the key of the TX vector in the threshold table
+     */
+    static uint64_t GetThresholdKey(const WifiTxVector& txVector);
+
+    /**
+     * \param mode the non-HT mode
+     * \return the channel width of the mode
+     */
+    static uint16_t GetChannelWidthForNonHtMode(WifiMode mode);
+
+    /**
+     * \param station the station
+     * \param channelWidth the channel width
+     * \param nss the number of spatial streams
+     * \return the last observed SNR of the station, scaled to the channel width and NSS
+     */
+    static double GetLastObservedSnr(const AutoMcsWifiRemoteStation* station,
+                                     uint16_t channelWidth,
+                                     uint8_t nss);
+
+    double m_ber;                                  //!< The maximum Bit Error Rate acceptable at any transmission mode
+    std::shared_ptr<const Thresholds> m_thresholds; //!< Minimum SNR of each TX vector, shared by managers with the same PHY capabilities
+    TracedValue<uint64_t> m_currentRate;           //!< Trace rate changes
+    uint64_t m_mcsSum;                             //!< Sum of the MCSs of the acknowledged MPDUs
+    uint64_t m_mcsCount;                           //!< Number of acknowledged MPDUs
+    int m_meanMcs;                                 //!< Rounded up mean MCS that m_meanMcsMode was built for
+    WifiMode m_meanMcsMode;                        //!< HE mode of m_meanMcs
+    WifiMode m_rtsMode;                            //!< RTS mode if autoMCS is enabled
+    bool m_autoMCS;                                //!< Enable constant rate after a while
+};
+
+} // namespace ns3
+
+#endif /* AUTO_MCS_WIFI_MANAGER_H */
@@ -7,8 +7,12 @@
 
 #include "data-processor.h"
 #include <sys/time.h>
+#include <sys/wait.h>
 #include <unistd.h>
+#include <cerrno>
+#include <cstring>
 #include <chrono>
+#include <algorithm>
 using json = nlohmann::json;
 
 namespace ns3 {
@@ -20,39 +24,160 @@ NetworkStats::NetworkStats (std::string source, uint64_t id, uint64_t ts)
   m_id = id;
   m_ts = ts;
 }
+
+NetworkStats::NetworkStats (std::string source)
+  : NetworkStats (source, 0, 0)
+{
+}
+
 NetworkStats::~NetworkStats ()
 {
 
 }
 
-json
-NetworkStats::GetJson()
+NetworkStats::Metric&
+NetworkStats::GetMetric(const std::string& name)
+{
+  for (auto& metric : m_metrics)
+  {
+    if (metric.name == name)
+    {
+      return metric;
+    }
+  }
+  Metric metric;
+  metric.name = name;
+  m_metrics.push_back(std::move(metric));
+  return m_metrics.back();
+}
+
+void
+NetworkStats::Append(const std::string& name, std::span<const uint64_t> ids, std::span<const double> values)
+{
+  if (ids.size() != values.size())
+  {
+    NS_FATAL_ERROR("The size of the id and value list is not the same!!!");
+  }
+  Metric& metric = GetMetric(name);
+  metric.ids.insert(metric.ids.end(), ids.begin(), ids.end());
+  if (metric.isJson)
+  {
+    metric.jsonValues.insert(metric.jsonValues.end(), values.begin(), values.end());
+  }
+  else
+  {
+    metric.values.insert(metric.values.end(), values.begin(), values.end());
+  }
+  m_dataValid = false;
+}
+
+void
+NetworkStats::Reset(uint64_t ts)
 {
+  m_ts = ts;
+  for (auto& metric : m_metrics)
+  {
+    metric.ids.clear();
+    metric.values.clear();
+    metric.jsonValues.clear();
+    metric.isJson = false;
+  }
+  m_dataValid = false;
+}
+
+const std::string&
+NetworkStats::GetSource() const
+{
+  return m_source;
+}
+
+uint64_t
+NetworkStats::GetTs() const
+{
+  return m_ts;
+}
+
+const std::vector<NetworkStats::Metric>&
+NetworkStats::GetMetrics() const
+{
+  return m_metrics;
+}
+
+std::vector<NetworkStats::Metric>&
+NetworkStats::TakeMetrics()
+{
+  m_dataValid = false;
+  return m_metrics;
+}
+
+const json&
+NetworkStats::GetJson() const
+{
+  if (!m_dataValid)
+  {
+    //one entry per metric, i.e., {"source", "name", "ts", "id":[], "value":[]}.
+    m_data = json();
+    for (const auto& metric : m_metrics)
+    {
+      if (metric.ids.empty())
+      {
+        continue;
+      }
+      json measurement;
+      measurement["source"] = m_source;
+      measurement["id"] = metric.ids;
+      measurement["ts"] = m_ts;
+      measurement["name"] = metric.name;
+      if (metric.isJson)
+      {
+        measurement["value"] = metric.jsonValues;
+      }
+      else
+      {
+        measurement["value"] = metric.values;
+      }
+      m_data.push_back(std::move(measurement));
+    }
+    m_dataValid = true;
+  }
   return m_data;
 }
 
 void
 NetworkStats::Append(std::string name, double value)
 {
-    json measurement;
-    measurement["source"] = m_source;
-    measurement["id"].push_back(m_id);
-    measurement["ts"] = m_ts;
-    measurement["name"] = name;
-    measurement["value"].push_back(value);
-    m_data.push_back(measurement);
+  Metric& metric = GetMetric(name);
+  metric.ids.push_back(m_id);
+  if (metric.isJson)
+  {
+    metric.jsonValues.push_back(value);
+  }
+  else
+  {
+    metric.values.push_back(value);
+  }
+  m_dataValid = false;
 }
 
 void
 NetworkStats::Append(std::string name, json& value)
 {
-    json measurement;
-    measurement["source"] = m_source;
-    measurement["id"].push_back(m_id);
-    measurement["ts"] = m_ts;
-    measurement["name"] = name;
-    measurement["value"].push_back(value);
-    m_data.push_back(measurement);
+  if (value.is_number_float())
+  {
+    Append(name, value.get<double>());
+    return;
+  }
+  Metric& metric = GetMetric(name);
+  if (!metric.isJson)
+  {
+    //switch this metric to json values, e.g., integers or nested lists.
+    metric.jsonValues.assign(metric.values.begin(), metric.values.end());
+    metric.values.clear();
+    metric.isJson = true;
+  }
+  metric.ids.push_back(m_id);
+  metric.jsonValues.push_back(value);
+  m_dataValid = false;
 }
 
 void
@@ -62,18 +187,10 @@ NetworkStats::Append(std::string name, std::string indexName, std::vector<int> i
     {
       NS_FATAL_ERROR("The size of the indexName and list is not the same!!!");
     }
-    json measurement;
-    measurement["source"] = m_source;
-    measurement["id"].push_back(m_id);
-    measurement["ts"] = m_ts;
-    measurement["name"] = name;
     json item;
     item[indexName] = indexList;
     item["value"] = list;
-
-    measurement["value"].push_back(item);
-
-    m_data.push_back(measurement);
+    Append(name, item);
 }
 
 NS_LOG_COMPONENT_DEFINE ("DataProcessor");
@@ -87,6 +204,12 @@ DataProcessor::GetTypeId (void)
     .SetParent<Object> ()
     .SetGroupName("networkgym")
     .AddConstructor<DataProcessor> ()
+    .AddAttribute ("Verbosity",
+                   "0 disables the per node diagnostic output of the scenario, larger values enable it. The per step "
+                   "output of the module is logged by the NS_LOG components, which are compiled out in optimized builds.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&DataProcessor::m_verbosity),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -95,6 +218,7 @@ DataProcessor::DataProcessor ()
 {
   NS_LOG_FUNCTION (this);
   m_southbound = CreateObject<SouthboundInterface>();
+  m_phaseTimer = &m_southbound->GetPhaseTimer();
   m_waitCounter = 0;
   m_waitSysTimeMs = 0;
   m_startSysTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
@@ -103,12 +227,133 @@ DataProcessor::DataProcessor ()
   std::ifstream jsonStreamEnv("env-configure.json");
   json jsonConfigEnv;
   jsonStreamEnv >> jsonConfigEnv;
-  m_totalSteps = jsonConfigEnv["steps_per_episode"].get<uint64_t>() * jsonConfigEnv["episodes_per_session"].get<uint64_t>();
+  m_stepsPerEpisode = jsonConfigEnv["steps_per_episode"].get<uint64_t>();
+  m_totalSteps = m_stepsPerEpisode * jsonConfigEnv["episodes_per_session"].get<uint64_t>();
+  if (jsonConfigEnv.contains("measurement_encoding"))
+  {
+    //opt-in binary encoding of the network stats, e.g., "msgpack" or "cbor".
+    m_southbound->SetAttribute("MeasurementEncoding", StringValue(jsonConfigEnv["measurement_encoding"].get<std::string>()));
+  }
+  if (jsonConfigEnv.contains("zmq_socket_options"))
+  {
+    //opt-in socket tuning for multi-MB network stats, e.g., {"send_hwm": 1000, "send_buffer_bytes": 4194304}.
+    const json& options = jsonConfigEnv["zmq_socket_options"];
+    m_southbound->SetAttribute("SendHighWaterMark", IntegerValue(options.value("send_hwm", 1000)));
+    m_southbound->SetAttribute("SendBufferSize", IntegerValue(options.value("send_buffer_bytes", 0)));
+    m_southbound->SetAttribute("ReceiveBufferSize", IntegerValue(options.value("receive_buffer_bytes", 0)));
+  }
+  if (jsonConfigEnv.contains("action_lag_steps"))
+  {
+    //opt-in pipelined mode, the simulation continues with the previous action while the agent computes the next one.
+    m_actionLagSteps = jsonConfigEnv["action_lag_steps"].get<uint32_t>();
+  }
+  if (jsonConfigEnv.contains("steps_per_exchange"))
+  {
+    //opt-in batched mode for data collection, one round trip per K steps. The steps in between apply the
+    //"action_steps" of the last action, or the GetNoneAiAction.
+    m_stepsPerExchange = std::max<uint32_t>(1, jsonConfigEnv["steps_per_exchange"].get<uint32_t>());
+  }
+  if (jsonConfigEnv.contains("agent_groups"))
+  {
+    //e.g., [{"name": "bss0", "source": "MultiBss", "id_range": [0, 3]}], the source and id_range are optional.
+    for (const auto& groupConfig : jsonConfigEnv["agent_groups"])
+    {
+      AgentGroup group;
+      group.name = groupConfig["name"].get<std::string>();
+      if (groupConfig.contains("source"))
+      {
+        group.source = groupConfig["source"].get<std::string>();
+      }
+      if (groupConfig.contains("id_range"))
+      {
+        group.minId = groupConfig["id_range"].at(0).get<uint64_t>();
+        group.maxId = groupConfig["id_range"].at(1).get<uint64_t>();
+      }
+      if (!m_agentGroupIndexMap.emplace(group.name, m_agentGroups.size()).second)
+      {
+        NS_FATAL_ERROR("The agent group with the same name already exists: " << group.name);
+      }
+      m_agentGroups.push_back(std::move(group));
+    }
+  }
+  if (jsonConfigEnv.contains("phase_timing"))
+  {
+    //opt-in, time the step phases and report their p50/p99 and the payload bytes as the step_phases of the workload stats.
+    m_phaseTimer->SetEnabled(jsonConfigEnv["phase_timing"].get<bool>());
+  }
+  if (jsonConfigEnv.contains("fork_episodes"))
+  {
+    //opt-in, build and warm up the topology once and fork a copy-on-write child per episode at the measurement start.
+    m_forkEpisodes = jsonConfigEnv["fork_episodes"].get<bool>();
+    if (m_forkEpisodes && !m_agentGroups.empty())
+    {
+      NS_FATAL_ERROR("The fork_episodes mode does not support the agent_groups.");
+    }
+  }
+  if (m_stepsPerExchange > 1 && (!m_agentGroups.empty() || m_actionLagSteps > 0))
+  {
+    NS_FATAL_ERROR("The steps_per_exchange mode does not support the agent_groups or the action_lag_steps.");
+  }
+  if (jsonConfigEnv.contains("record_path"))
+  {
+    //opt-in recording of the network stats of every step and the applied actions, see MeasurementRecorder.
+    m_recordPath = jsonConfigEnv["record_path"].get<std::string>();
+    if (!m_agentGroups.empty())
+    {
+      NS_FATAL_ERROR("The record_path does not support the agent_groups.");
+    }
+  }
+  if (jsonConfigEnv.contains("replay_path"))
+  {
+    //opt-in replay of a MeasurementRecorder file instead of the simulated measurements, e.g., by scratch/replay.cc.
+    m_replay.Open(jsonConfigEnv["replay_path"].get<std::string>());
+    m_replayMode = true;
+    m_replayStrict = jsonConfigEnv.value("replay_strict", false);
+    if (!m_agentGroups.empty() || m_forkEpisodes)
+    {
+      NS_FATAL_ERROR("The replay_path does not support the agent_groups or the fork_episodes.");
+    }
+  }
+  if (jsonConfigEnv.contains("delta_network_stats"))
+  {
+    //opt-in on-change reporting, e.g., ["Obss::Cpp2Py::NodeX"], with a keyframe every "delta_keyframe_steps" steps.
+    for (const auto& sourceAndName : jsonConfigEnv["delta_network_stats"])
+    {
+      m_delta.Add(sourceAndName.get<std::string>());
+    }
+    m_delta.SetKeyframeSteps(jsonConfigEnv.value("delta_keyframe_steps", 100));
+    if (m_delta.IsEnabled() && !m_agentGroups.empty())
+    {
+      NS_FATAL_ERROR("The delta_network_stats does not support the agent_groups.");
+    }
+  }
+  if (jsonConfigEnv.contains("policy_library"))
+  {
+    //opt-in in-process policy, e.g., "/path/to/libmy-policy.so", the networkgym server and client are not used.
+    m_policy = InProcessPolicy::Load(jsonConfigEnv["policy_library"].get<std::string>());
+    m_policy->Configure(jsonConfigEnv);
+  }
+  if (m_policy && !m_agentGroups.empty())
+  {
+    NS_FATAL_ERROR("The policy_library does not support the agent_groups.");
+  }
   uint32_t mSize = jsonConfigEnv["subscribed_network_stats"].size();
   for (uint32_t i = 0; i < mSize; i++)
   {
     //std::cout << jsonConfigEnv["subscribed_network_stats"].at(i) << std::endl;
-    m_subscribedMeasurement.push_back(jsonConfigEnv["subscribed_network_stats"].at(i));
+    //the subscribed name is source::name, e.g., "Obss::Cpp2Py::NodeX" -> source "Obss" and name "Cpp2Py::NodeX".
+    const std::string& sourceAndName = jsonConfigEnv["subscribed_network_stats"].at(i).get_ref<const std::string&>();
+    size_t pos = sourceAndName.find("::");
+    if (pos == std::string::npos)
+    {
+      NS_FATAL_ERROR("The subscribed network stats should be in the format of source::name, but received: " << sourceAndName);
+    }
+    uint32_t key = m_measurementBatch.Intern(std::string_view(sourceAndName).substr(0, pos), std::string_view(sourceAndName).substr(pos + 2));
+    if (key >= m_subscribedMeasurement.size())
+    {
+      m_subscribedMeasurement.resize(key + 1, false);
+    }
+    m_subscribedMeasurement[key] = true;
   }
 }
 
@@ -129,41 +374,73 @@ DataProcessor::DoDispose()
     uint64_t simTime = timeLapse - m_waitSysTimeMs;
     std::cout<<"ns3 Sim time :"<<  simTime << " milliseconds. (" << simTime*100/timeLapse <<"%)\n";
   }
+  if (m_replayMode)
+  {
+    std::cout << "Replay: " << m_replayActionMismatches << " of " << m_replayCheckedActions << " actions differ from the recording.\n";
+  }
   m_southbound->Dispose();
+  m_recorder.Close();
+  if (m_policy)
+  {
+    m_policy->Dispose();
+    m_policy = nullptr;
+  }
 }
 
 void
 DataProcessor::AppendMeasurement(Ptr<NetworkStats> measurement)
 {
-  if(!m_measurementStarted)
+  if(!m_measurementStarted || m_replayMode)
   {
     return;
   }
   
+  uint64_t appendStartUs = m_phaseTimer->Start();
+  if (!m_agentGroups.empty())
+  {
+    AppendAgentMeasurement(measurement);
+    m_phaseTimer->Stop(PhaseTimer::APPEND, appendStartUs);
+    return;
+  }
+
   Time maxWaitTime = NanoSeconds(1);
   //std::cout << measurement->GetJson() << std::endl;
   //only keep the measurement in the subscribed list
-  json measurementJson = measurement->GetJson();
-  json subJson;
-  for(auto it = measurementJson.begin(); it != measurementJson.end(); ++it)
+  //the typed columns are moved into the batch directly, the measurement json is not built. The values of a key
+  //appended by several measurements are copied, they are merged into one entry sorted by id.
+  for (auto& metric : measurement->TakeMetrics())
   {
-      auto sourceAndName = (*it)["source"].get<std::string>() + "::"+ (*it)["name"].get<std::string>();
-      //std::cout<< sourceAndName << std::endl;
-      if (std::find(m_subscribedMeasurement.begin(), m_subscribedMeasurement.end(),sourceAndName)!=m_subscribedMeasurement.end())
+      uint32_t key = m_measurementBatch.Find(measurement->GetSource(), metric.name);
+      if (metric.ids.empty() || key >= m_subscribedMeasurement.size() || !m_subscribedMeasurement[key])
+      {
+        continue;
+      }
+      if (metric.isJson)
+      {
+        m_measurementBatch.Append(key, measurement->GetTs(), metric.ids, metric.jsonValues);
+      }
+      else
       {
-        //std::cout << " FIND IT !" << std::endl;
-        subJson.push_back(*it);
+        m_measurementBatch.Append(key, measurement->GetTs(), std::move(metric.ids), std::move(metric.values));
       }
   }
-  m_measurementBatch.push_back(subJson);
+  m_measurementBatchSize++;
+  m_phaseTimer->Stop(PhaseTimer::APPEND, appendStartUs);
 
-  //TODO: for multi-agent case, we should not use the delayed schedule event. we send the measurement right away.
+  //the measurements appended in the same step are merged and sent together. The multi-agent mode sends them right away.
   if (m_exchangeMeasurementAndActionEvent.IsExpired())
   {
     m_exchangeMeasurementAndActionEvent = Simulator::Schedule(maxWaitTime, &DataProcessor::ExchangeMeasurementAndAction, this);
   }
 }
 
+bool
+DataProcessor::IsSubscribed(std::string_view source, std::string_view name) const
+{
+  uint32_t key = m_measurementBatch.Find(source, name);
+  return key < m_subscribedMeasurement.size() && m_subscribedMeasurement[key];
+}
+
 void
 DataProcessor::ExchangeMeasurementAndAction()
 {
@@ -172,111 +449,285 @@ DataProcessor::ExchangeMeasurementAndAction()
     return;
   }
 
-  if (m_measurementBatch.size() == 0)
+  if (m_measurementBatchSize == 0)
   {
     return;
   }
 
+  m_phaseTimer->Stop(PhaseTimer::SIMULATE, m_stepEndUs);
+  uint64_t mergeStartUs = m_phaseTimer->Start();
   AddMoreMeasurement();
-  json networkStats = m_measurementBatch.at(0); //networkStats is the json based measurement
-  std::vector<std::string> nameList; //namelist stores the source::name list of the measurement
-  for(auto it = networkStats.begin(); it != networkStats.end(); ++it)
+  m_measurementBatchSize = 0;
+  if (m_sendColumns)
+  {
+    //the binary frame is encoded from the merged columns by the southbound interface, the json is not built.
+    m_phaseTimer->Stop(PhaseTimer::MERGE, mergeStartUs);
+    m_measurementSentTsMs = Now().GetMilliSeconds();
+    m_measurementSentCounter += 1;
+    json workloadStats = GetWorkloadStats();
+    NS_LOG_INFO (Now().GetSeconds() << " NetworkGym Southbound Send Measurement");
+    m_southbound->SendMeasurementColumns(m_measurementBatch, workloadStats);
+    m_measurementBatch.Clear();
+    m_pendingActionTsMs.push_back(m_measurementSentTsMs);
+    FinishExchange();
+    return;
+  }
+  json networkStats = m_measurementBatch.Flush(); //networkStats is the json based measurement, one entry per source::name with sorted ids.
+  m_phaseTimer->Stop(PhaseTimer::MERGE, mergeStartUs);
+  ExchangeNetworkStats(networkStats);
+}
+
+void
+DataProcessor::ExchangeNetworkStats(json& networkStats)
+{
+  m_measurementSentTsMs = Now().GetMilliSeconds();
+  m_recorder.RecordStep(m_measurementSentCounter, m_measurementSentTsMs, networkStats);
+  m_measurementSentCounter += 1;
+  if (m_delta.IsEnabled() && !m_policy)
+  {
+    //after the recording, which keeps the full network stats. The in-process policy reads them in full as well.
+    m_delta.Encode(networkStats);
+  }
+  json workloadStats;
+  if (m_stepsPerExchange > 1)
   {
-    auto sourceAndName = (*it)["source"].get<std::string>() + "::"+ (*it)["name"].get<std::string>();
-    if (nameList.empty())
+    //batched mode, the entries of each step keep their own ts. The last step of an episode is always sent.
+    for (auto& entry : networkStats)
     {
-      nameList.push_back(sourceAndName);
+      m_exchangeNetworkStats.push_back(std::move(entry));
     }
-    else
+    m_exchangeSteps++;
+    if (m_exchangeSteps < m_stepsPerExchange && m_measurementSentCounter < m_totalSteps && m_measurementSentCounter < m_episodeEndStep)
     {
-      if (find(nameList.begin(), nameList.end(), sourceAndName) == nameList.end())
-      {
-        nameList.push_back(sourceAndName);
-      }
+      ApplyStepAction();
+      m_stepEndUs = m_phaseTimer->Start();
+      return;
     }
+    networkStats = std::move(m_exchangeNetworkStats);
+    m_exchangeNetworkStats = json::array();
+    workloadStats = GetWorkloadStats();
+    workloadStats["exchange_steps"] = m_exchangeSteps;
+    m_exchangeSteps = 0;
   }
-
-  //build nested json
-  for (uint32_t ind = 1; ind < m_measurementBatch.size(); ind++)
+  else
+  {
+    workloadStats = GetWorkloadStats();
+  }
+  if (m_policy)
+  {
+    //in-process policy, nothing is sent and the action is applied right away. As in the server mode, the last
+    //measurement does not have an action.
+    if (m_measurementSentCounter < m_totalSteps)
+    {
+      ApplyPolicyAction(networkStats);
+    }
+  }
+  else
   {
-    //loop over all measurement in this batch.
+    NS_LOG_INFO (Now().GetSeconds() << " NetworkGym Southbound Send Measurement");
     //std::cout << networkStats << std::endl;
-    //std::cout << nameList.size() << std::endl;
+    m_southbound->SendMeasurementJson(networkStats, workloadStats);
+    m_pendingActionTsMs.push_back(m_measurementSentTsMs);
+  }
+  FinishExchange();
+}
 
-    for(auto j = m_measurementBatch.at(ind).begin(); j != m_measurementBatch.at(ind).end(); ++j)
+void
+DataProcessor::FinishExchange()
+{
+  if (m_measurementSentCounter >= m_totalSteps)
+  {
+    //the first step is the reset function which does not need an action. therefore the last measurement does not have an action.
+    m_measurementStarted = false; //simulated the max number of steps. stop sending measurement and receive actions.
+    if (!m_policy)
     {
-      //for each measurement entry, it may contain multiple metrics, loop them all.
-      auto it = networkStats.begin();
-      while(it != networkStats.end())
-      {
-        //for each network stats, loop all metrics
-        //for measurement from different group...
-        //we need to append measurement at the outer loop...
-        //std::cout << "out : "<< (*j) << std::endl;
-        //auto sourceAndName = (*it)["source"].get<std::string>() + "::"+ (*it)["name"].get<std::string>();
-        //std::cout << "in : "<< (*it) << std::endl;
-
-        if ( (*it)["source"] == (*j)["source"] && (*it)["name"] == (*j)["name"])
-        {
-          //same source and name --> same measurement... append to the id and value list
-          if ((*it)["ts"] != (*j)["ts"])
-          {
-            NS_FATAL_ERROR("the timestamp of two measurements are different!");
-          }
-
-          //save the the list in a sorted order.
-          uint32_t index = 0;
-          while (index <= (*it)["id"].size())
-          {
-            //the new element is greater than all existing element, push it into the back.
-            if (index == (*it)["id"].size())
-            {
-              (*it)["id"].push_back((*j)["id"].at(0));
-              (*it)["value"].push_back((*j)["value"].at(0));
-              break;
-            }
-
-            //put value in a sorted way...
-            if ((*it)["id"].at(index) > (*j)["id"].at(0))
-            {
-              (*it)["id"].insert((*it)["id"].begin()+index, (*j)["id"].at(0));
-              (*it)["value"].insert((*it)["value"].begin()+index, (*j)["value"].at(0));
-              break;
-            }
-            index++;
-          }
-
-          break;
-        }
-        else
-        {
-          //check if we need to append to network stats.
-          auto sourceAndNameTemp = (*j)["source"].get<std::string>() + "::"+ (*j)["name"].get<std::string>();
-          if (nameList.empty())
-          {
-            nameList.push_back(sourceAndNameTemp);
-            networkStats.push_back((*j));
-            break;
-          }
-          else
-          {
-            if (find(nameList.begin(), nameList.end(), sourceAndNameTemp) == nameList.end())
-            {
-              nameList.push_back(sourceAndNameTemp);
-              networkStats.push_back(*j);
-              break;
-
-            }
-          }
-        }
-        it++;
-      }
+      m_pendingActionTsMs.pop_back();
+    }
+    while (!m_pendingActionTsMs.empty())
+    {
+      //pipelined mode, receive the actions that are still in flight.
+      ReceiveAndApplyAction();
+    }
+    if (m_episodeEndStep != UINT64_MAX)
+    {
+      Simulator::Stop(); //forked last episode, the remaining simulation time belongs to the other episodes.
+    }
+    return;
+  }
+
+  if (m_measurementSentCounter >= m_episodeEndStep)
+  {
+    //forked episode, the agent replies to the last measurement of an episode with the reset action. Receive it and stop,
+    //the first measurement of the next child is the observation returned by the reset.
+    m_measurementStarted = false;
+    while (!m_pendingActionTsMs.empty())
+    {
+      ReceiveAndApplyAction();
     }
+    Simulator::Stop();
+    return;
+  }
 
+  //blocking mode (m_actionLagSteps = 0) waits for the action of this measurement. In the pipelined mode, the action of
+  //measurement k is applied when measurement k + m_actionLagSteps is sent, until then the simulation continues with the previous action.
+  while (m_pendingActionTsMs.size() > m_actionLagSteps)
+  {
+    ReceiveAndApplyAction();
   }
-  m_measurementSentTsMs = Now().GetMilliSeconds();
-  std::cout << Now().GetSeconds() << " NetworkGym Southbound Send Measurement"<< std::endl;
-  //std::cout << networkStats << std::endl;
+  m_stepEndUs = m_phaseTimer->Start();
+}
+
+void
+DataProcessor::ReplayStep(uint32_t index)
+{
+  if (!m_measurementStarted)
+  {
+    return;
+  }
+  m_phaseTimer->Stop(PhaseTimer::SIMULATE, m_stepEndUs);
+  const auto& steps = m_replay.GetSteps();
+  json networkStats = m_replay.GetNetworkStats(steps[index]);
+  ExchangeNetworkStats(networkStats);
+  if (m_measurementStarted && index + 1 < steps.size())
+  {
+    //the recorded cadence in simulation time. The wall clock pace is set by the simulator implementation, e.g., the
+    //RealtimeSimulatorImpl replays in real time, the default one as fast as possible.
+    Time next = std::max(MilliSeconds(static_cast<int64_t>(steps[index + 1].tsMs)) - Now(), Time(0));
+    Simulator::Schedule(next, &DataProcessor::ReplayStep, this, index + 1);
+  }
+  else if (m_measurementStarted)
+  {
+    NS_LOG_WARN ("The replay ended after " << steps.size() << " steps, before the steps_per_episode x episodes_per_session steps.");
+    m_measurementStarted = false;
+    while (!m_pendingActionTsMs.empty())
+    {
+      ReceiveAndApplyAction();
+    }
+  }
+}
+
+void
+DataProcessor::CheckReplayAction(const json& actionList, double tsMs)
+{
+  const json* recorded = m_replay.GetAction(tsMs);
+  if (!recorded)
+  {
+    return; //e.g., the recording ended, or the measurement was the last one of the recording.
+  }
+  m_replayCheckedActions++;
+  if (*recorded != actionList)
+  {
+    m_replayActionMismatches++;
+    if (m_replayStrict)
+    {
+      NS_FATAL_ERROR("The action of the measurement at " << tsMs << " ms differs from the recording. Received: "
+                     << actionList << " recorded: " << *recorded);
+    }
+    NS_LOG_WARN ("The action of the measurement at " << tsMs << " ms differs from the recording.");
+  }
+}
+
+void
+DataProcessor::DispatchAction(const json& actionList, double tsMs)
+{
+  m_recorder.RecordAction(m_measurementSentCounter, tsMs, actionList);
+  if (m_replayMode)
+  {
+    return; //there is no simulated network to apply the action to.
+  }
+  m_actionDispatcher.Dispatch(actionList, tsMs);
+}
+
+void
+DataProcessor::ReceiveAndApplyAction()
+{
+  //std::cout << m_waitCounter << " total: " << m_totalSteps << std::endl;
+  uint64_t beforePollMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+  json action;
+  //in pipelined mode, the actions of the later measurements may already be queued. Receive them one by one.
+  m_southbound->GetAction(action, true, m_actionLagSteps == 0);
+  GetNoneAiAction(action);
+  uint64_t afterPollMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  //compute the time ns3 waits for action.
+  m_waitSysTimeMs += afterPollMs - beforePollMs;
+  m_waitCounter += 1;
+
+  ApplyAction(action, m_pendingActionTsMs.front());
+  m_pendingActionTsMs.pop_front();
+}
+
+void
+DataProcessor::ApplyAction(json& action, double tsMs)
+{
+  if (action.contains("action_steps"))
+  {
+    //batched mode, one action list per step of the next exchange. The first one is applied now, the others by
+    //ApplyStepAction. An action with only the action_list holds it until the next exchange.
+    m_actionSteps.assign(action["action_steps"].begin(), action["action_steps"].end());
+    m_actionStepsTsMs = tsMs;
+    if (!m_actionSteps.empty())
+    {
+      action["action_list"] = std::move(m_actionSteps.front());
+      m_actionSteps.pop_front();
+    }
+  }
+  else
+  {
+    m_actionSteps.clear();
+  }
+
+  //send the action to subscribed module.
+  NS_LOG_DEBUG (action["action_list"] << " is_array:" << action["action_list"].is_array());
+  //send action to the connected callback. The key is the measurement <source::name, id>, the action ts should equal the measurement ts.
+  if (m_replayMode)
+  {
+    CheckReplayAction(action["action_list"], tsMs);
+  }
+  uint64_t dispatchStartUs = m_phaseTimer->Start();
+  DispatchAction(action["action_list"], tsMs);
+  m_phaseTimer->Stop(PhaseTimer::DISPATCH, dispatchStartUs);
+}
+
+void
+DataProcessor::ApplyPolicyAction(const json& networkStats)
+{
+  //the in-process policy replaces the send and the wait for the action, its time is recorded as the wait phase.
+  uint64_t waitStartUs = m_phaseTimer->Start();
+  json action;
+  action["action_list"] = json::array();
+  m_policy->GetAction(networkStats, m_measurementSentTsMs, action["action_list"]);
+  GetNoneAiAction(action);
+  m_phaseTimer->Stop(PhaseTimer::WAIT, waitStartUs);
+  ApplyAction(action, m_measurementSentTsMs);
+}
+
+void
+DataProcessor::ApplyStepAction()
+{
+  uint64_t dispatchStartUs = m_phaseTimer->Start();
+  if (!m_actionSteps.empty())
+  {
+    //the entries carry the ts of the measurement they replied to, i.e., the last one of the previous exchange.
+    DispatchAction(m_actionSteps.front(), m_actionStepsTsMs);
+    m_actionSteps.pop_front();
+  }
+  else
+  {
+    json action;
+    action["action_list"] = json::array();
+    GetNoneAiAction(action);
+    if (!action["action_list"].empty())
+    {
+      DispatchAction(action["action_list"], m_measurementSentTsMs);
+    }
+  }
+  m_phaseTimer->Stop(PhaseTimer::DISPATCH, dispatchStartUs);
+}
+
+json
+DataProcessor::GetWorkloadStats()
+{
   uint64_t currentSysTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
   uint64_t timeLapse = currentSysTime - m_startSysTimeMs;
   uint64_t simTimeLaps = timeLapse - m_waitSysTimeMs;
@@ -298,114 +749,311 @@ DataProcessor::ExchangeMeasurementAndAction()
  
   json workloadStats;
   workloadStats["time_lapse"].push_back(element);
+  if (m_replayMode)
+  {
+    workloadStats["replay"]["checked_actions"] = m_replayCheckedActions;
+    workloadStats["replay"]["action_mismatches"] = m_replayActionMismatches;
+  }
+  if (m_delta.IsEnabled())
+  {
+    workloadStats["delta_omitted_values"] = m_delta.GetOmittedValues();
+  }
+  if (m_phaseTimer->IsEnabled())
+  {
+    workloadStats["step_phases"] = m_phaseTimer->GetJson(); //cumulative since the measurement start, up to the previous step.
+  }
 
-  m_southbound->SendMeasurementJson(networkStats, workloadStats);
-  m_measurementBatch.clear();
+  return workloadStats;
+}
 
-  if (m_waitCounter+1 >= m_totalSteps)
+uint32_t
+DataProcessor::FindAgentGroup(std::string_view source, uint64_t id) const
+{
+  for (uint32_t i = 0; i < m_agentGroups.size(); i++)
   {
-    //the first step is the reset function which does not need an action. therefore we +1.
-    m_measurementStarted = false; //simulated the max number of steps. stop sending measurement and receive actions.
-    return;
+    const AgentGroup& group = m_agentGroups[i];
+    if ((group.source.empty() || group.source == source) && id >= group.minId && id <= group.maxId)
+    {
+      return i;
+    }
   }
+  return UINT32_MAX;
+}
 
-  //std::cout << m_waitCounter << " total: " << m_totalSteps << std::endl;
-  uint64_t beforePollMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+void
+DataProcessor::AppendAgentMeasurement(Ptr<NetworkStats> measurement)
+{
+  //split the subscribed values into the agent groups by source and id.
+  std::vector<uint32_t> groupKeys(m_agentGroups.size());
+  for (const auto& metric : measurement->GetMetrics())
+  {
+    uint32_t key = m_measurementBatch.Find(measurement->GetSource(), metric.name);
+    if (metric.ids.empty() || key >= m_subscribedMeasurement.size() || !m_subscribedMeasurement[key])
+    {
+      continue;
+    }
+    std::fill(groupKeys.begin(), groupKeys.end(), MeasurementAggregator::INVALID_KEY);
+    for (uint32_t i = 0; i < metric.ids.size(); i++)
+    {
+      uint32_t groupIndex = FindAgentGroup(measurement->GetSource(), metric.ids[i]);
+      if (groupIndex == UINT32_MAX)
+      {
+        NS_FATAL_ERROR("No agent group for the measurement: " << measurement->GetSource() << "::" << metric.name << " and id:" << metric.ids[i]);
+      }
+      AgentGroup& group = m_agentGroups[groupIndex];
+      if (groupKeys[groupIndex] == MeasurementAggregator::INVALID_KEY)
+      {
+        groupKeys[groupIndex] = group.batch.Intern(measurement->GetSource(), metric.name);
+      }
+      if (metric.isJson)
+      {
+        group.batch.Append(groupKeys[groupIndex], measurement->GetTs(), metric.ids[i], metric.jsonValues[i]);
+      }
+      else
+      {
+        group.batch.Append(groupKeys[groupIndex], measurement->GetTs(), metric.ids[i], metric.values[i]);
+      }
+    }
+  }
+
+  //the values appended in the same step are merged per group, and exchanged together.
+  if (m_exchangeAgentMeasurementsEvent.IsExpired())
+  {
+    m_exchangeAgentMeasurementsEvent = Simulator::Schedule(NanoSeconds(1), &DataProcessor::ExchangeAgentMeasurements, this);
+  }
+}
 
+void
+DataProcessor::ExchangeAgentMeasurements()
+{
+  if (!m_measurementStarted)
+  {
+    return;
+  }
+  //the actions that arrived since the last step are applied first, they may let a slow group send again.
   json action;
-  m_southbound->GetAction(action, true);
-  GetNoneAiAction(action);
-  uint64_t afterPollMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-  //compute the time ns3 waits for action.
-  m_waitSysTimeMs += afterPollMs - beforePollMs;
-  m_waitCounter += 1;
+  while (m_southbound->PollAction(action))
+  {
+    ApplyAgentAction(action);
+  }
 
-  //send the action to subscribed module.
-  std::cout << action["action_list"] << " is_array:" << action["action_list"].is_array()<< std::endl;
-  //send action to the connected callback. The key is the measurement <source::name, id>.
-  if(action["action_list"].is_array())
+  bool allDone = true;
+  for (auto& group : m_agentGroups)
   {
-    for (uint32_t i = 0; i < action["action_list"].size(); i++)
+    if (!group.batch.IsEmpty())
     {
-      auto action_name = action["action_list"][i]["source"].get<std::string>() +"::"+ action["action_list"][i]["name"].get<std::string>();
-      
-      if (action["action_list"][i]["value"].is_array())
+      if (group.measurementCounter < m_totalSteps)
       {
-        for (uint32_t it = 0; it < action["action_list"][i]["id"].size(); it++)
-        {
-          auto key = std::make_pair(action_name, action["action_list"][i]["id"][it]);
-          //std::cout << action["action_list"][i]["value"] << std::endl;
-          if(m_networkgymActionCallbackMap.find(key) == m_networkgymActionCallbackMap.end())
-          {
-            NS_FATAL_ERROR("callback does not exits for the action_name: "<< key.first << " and id:" << key.second);
-          }
-          if (m_measurementSentTsMs != action["action_list"][i]["ts"])
-          {
-            NS_FATAL_ERROR("the action ts:"<< action["action_list"][i]["ts"] <<" does not equal the measurement ts:" << m_measurementSentTsMs);
-          }
-          m_networkgymActionCallbackMap[key](action["action_list"][i]["value"][it]);
-        }
+        group.queuedMeasurements.push_back({static_cast<double>(Now().GetMilliSeconds()), group.batch.Flush()});
+        group.measurementCounter += 1;
       }
       else
       {
-        if (m_measurementSentTsMs != action["action_list"][i]["ts"])
-        {
-          NS_FATAL_ERROR("the action ts:"<< action["action_list"][i]["ts"] <<" does not equal the measurement ts:" << m_measurementSentTsMs);
-        }
-        auto key = std::make_pair(action_name, action["action_list"][i]["id"]);
-        m_networkgymActionCallbackMap[key](action["action_list"][i]["value"]);
+        group.batch.Clear(); //this group simulated the max number of steps.
       }
+    }
+    SendAgentMeasurements(group);
+    allDone = allDone && group.measurementCounter >= m_totalSteps;
+  }
+  if (!allDone)
+  {
+    return;
+  }
 
+  //all groups simulated the max number of steps. Send the queued measurements as their actions arrive.
+  m_measurementStarted = false;
+  auto waiting = [this]() {
+    return std::any_of(m_agentGroups.begin(), m_agentGroups.end(),
+                       [](const AgentGroup& group) { return !group.pendingActionTsMs.empty(); });
+  };
+  while (waiting())
+  {
+    ReceiveAgentAction();
+    for (auto& group : m_agentGroups)
+    {
+      SendAgentMeasurements(group);
     }
   }
-  else
+}
+
+void
+DataProcessor::SendAgentMeasurements(AgentGroup& group)
+{
+  while (!group.queuedMeasurements.empty() && group.pendingActionTsMs.size() <= m_actionLagSteps)
   {
-    //not an array. This is one action list.
-    auto action_name = action["action_list"]["source"].get<std::string>() +"::"+action["action_list"]["name"].get<std::string>();
-    if (action["action_list"]["value"].is_array())
+    QueuedMeasurement& measurement = group.queuedMeasurements.front();
+    NS_LOG_INFO (Now().GetSeconds() << " NetworkGym Southbound Send Measurement of agent: " << group.name);
+    json workloadStats = GetWorkloadStats();
+    workloadStats["queued_measurements"] = group.queuedMeasurements.size() - 1; //the measurements of this group behind this one.
+    m_southbound->SendMeasurementJson(measurement.networkStats, workloadStats, group.name);
+
+    group.measurementSentCounter += 1;
+    if (group.measurementSentCounter < m_totalSteps)
     {
-      for (uint32_t it = 0; it < action["action_list"]["id"].size(); it++)
-      {
-        if (m_measurementSentTsMs != action["action_list"]["ts"])
-        {
-          NS_FATAL_ERROR("the action ts:"<< action["action_list"]["ts"] <<" does not equal the measurement ts:" << m_measurementSentTsMs);
-        }
-        auto key = std::make_pair(action_name, action["action_list"]["id"][it]);
-        if(m_networkgymActionCallbackMap.find(key) == m_networkgymActionCallbackMap.end())
-        {
-          NS_FATAL_ERROR("callback does not exits for the action_name: "<< key.first << " and id:" << key.second);
-        }
-        m_networkgymActionCallbackMap[key](action["action_list"]["value"][it]);
-      }
+      //the last measurement does not have an action.
+      group.pendingActionTsMs.push_back(measurement.tsMs);
+    }
+    group.queuedMeasurements.pop_front();
+  }
+}
+
+void
+DataProcessor::ReceiveAgentAction()
+{
+  uint64_t beforePollMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  json action;
+  //the actions of different agents share the socket, receive them one by one.
+  m_southbound->GetAction(action, true, false);
+  uint64_t afterPollMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  m_waitSysTimeMs += afterPollMs - beforePollMs;
+  m_waitCounter += 1;
+  ApplyAgentAction(action);
+}
+
+void
+DataProcessor::ApplyAgentAction(json& action)
+{
+  GetNoneAiAction(action);
+  if (!action.contains("agent"))
+  {
+    NS_FATAL_ERROR("The action should carry the \"agent\" name in the multi-agent mode.");
+  }
+  auto it = m_agentGroupIndexMap.find(action["agent"].get<std::string>());
+  if (it == m_agentGroupIndexMap.end())
+  {
+    NS_FATAL_ERROR("Unknown agent of the action: " << action["agent"]);
+  }
+  AgentGroup& group = m_agentGroups[it->second];
+  if (group.pendingActionTsMs.empty())
+  {
+    NS_FATAL_ERROR("Agent " << group.name << " sent an action without a pending measurement.");
+  }
+  NS_LOG_DEBUG (group.name << ": " << action["action_list"]);
+  uint64_t dispatchStartUs = m_phaseTimer->Start();
+  group.actionDispatcher.Dispatch(action["action_list"], group.pendingActionTsMs.front());
+  m_phaseTimer->Stop(PhaseTimer::DISPATCH, dispatchStartUs);
+  group.pendingActionTsMs.pop_front();
+}
+
+void
+DataProcessor::SetNetworkGymActionCallback(std::string name, uint64_t id, NetworkGymActionCallback cb)
+{
+  if (!m_agentGroups.empty())
+  {
+    //the callback belongs to the group of its source and id.
+    uint32_t groupIndex = FindAgentGroup(std::string_view(name).substr(0, name.find("::")), id);
+    if (groupIndex == UINT32_MAX)
+    {
+      NS_FATAL_ERROR("No agent group for the action callback: " << name << " and id:" << id);
     }
-    else
+    m_agentGroups[groupIndex].actionDispatcher.Add(name, id, cb);
+    return;
+  }
+  m_actionDispatcher.Add(name, id, cb);
+}
+
+void
+DataProcessor::SetNetworkGymBulkActionCallback(std::string name, NetworkGymBulkActionCallback cb)
+{
+  if (!m_agentGroups.empty())
+  {
+    //every group of the source dispatches the ids of its own actions to the callback.
+    std::string_view source = std::string_view(name).substr(0, name.find("::"));
+    bool added = false;
+    for (auto& group : m_agentGroups)
     {
-      if (m_measurementSentTsMs != action["action_list"]["ts"])
+      if (group.source.empty() || group.source == source)
       {
-        NS_FATAL_ERROR("the action ts:"<< action["action_list"]["ts"] <<" does not equal the measurement ts:" << m_measurementSentTsMs);
+        group.actionDispatcher.AddBulk(name, cb);
+        added = true;
       }
-      auto key = std::make_pair(action_name, action["action_list"]["id"]);
-      m_networkgymActionCallbackMap[key](action["action_list"]["value"]);
     }
-
+    if (!added)
+    {
+      NS_FATAL_ERROR("No agent group for the action callback: " << name);
+    }
+    return;
   }
+  m_actionDispatcher.AddBulk(name, cb);
 }
 
 void
-DataProcessor::SetNetworkGymActionCallback(std::string name, uint64_t id, NetworkGymActionCallback cb)
+DataProcessor::SetPolicy (Ptr<InProcessPolicy> policy)
 {
-  auto key = std::make_pair(name, id);
-  if(m_networkgymActionCallbackMap.find(key) != m_networkgymActionCallbackMap.end())
+  if (m_measurementStarted)
+  {
+    NS_FATAL_ERROR("The policy should be set before the measurement starts.");
+  }
+  if (!m_agentGroups.empty())
   {
-    NS_FATAL_ERROR("The callback with the same name and id already exists!");
+    NS_FATAL_ERROR("The in-process policy does not support the agent_groups.");
   }
-  m_networkgymActionCallbackMap[key] = cb;
+  m_policy = policy;
 }
 
 void
 DataProcessor::StartMeasurement ()
 {
+  if (m_forkEpisodes && ForkEpisodes())
+  {
+    return; //the parent never connects, the episodes are done by the children.
+  }
+  if (!m_policy)
+  {
+    m_southbound->Connect();
+  }
+  if (!m_recordPath.empty())
+  {
+    //the writer thread is started here, a thread does not survive the fork. Each forked episode has its own file.
+    m_recorder.Open(m_episodeEndStep == UINT64_MAX ? m_recordPath
+                    : m_recordPath + ".episode" + std::to_string(m_measurementSentCounter / m_stepsPerEpisode));
+  }
   m_measurementStarted = true;
+  //the json network stats are only built if they are sent as json or read by the recorder, the delta encoding, the
+  //batched mode or the in-process policy.
+  m_sendColumns = m_southbound->IsBinaryEncoding() && !m_policy && m_recordPath.empty() && !m_delta.IsEnabled()
+                  && m_stepsPerExchange == 1 && !m_replayMode;
+  if (m_replayMode && !m_replay.GetSteps().empty())
+  {
+    //the recorded ts are kept, the first step is replayed at its recorded time.
+    Time first = std::max(MilliSeconds(static_cast<int64_t>(m_replay.GetSteps().front().tsMs)) - Now(), Time(0));
+    Simulator::Schedule(first, &DataProcessor::ReplayStep, this, 0);
+  }
+}
+
+bool
+DataProcessor::ForkEpisodes ()
+{
+  //the topology is built and warmed up at this point. Every episode starts from this state in its own child, so the
+  //reset only costs a fork. The children run one after another and connect with the same env identity, the server
+  //hands the routing over to the new connection (ROUTER_HANDOVER).
+  m_forkEpisodes = false;
+  uint64_t episodes = m_totalSteps / m_stepsPerEpisode;
+  for (uint64_t episode = 0; episode < episodes; episode++)
+  {
+    //flush before the fork, otherwise the child prints the buffered output again.
+    std::cout.flush();
+    std::cerr.flush();
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+      NS_FATAL_ERROR("Cannot fork the episode " << episode << ": " << std::strerror(errno));
+    }
+    if (pid == 0)
+    {
+      m_measurementSentCounter = episode * m_stepsPerEpisode;
+      m_episodeEndStep = m_measurementSentCounter + m_stepsPerEpisode;
+      return false;
+    }
+    int status = 0;
+    if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+      NS_FATAL_ERROR("The forked episode " << episode << " failed.");
+    }
+    std::cout << "NetworkGym forked episode " << episode << " done." << std::endl;
+  }
+  Simulator::Stop();
+  return true;
 }
 
 bool
@@ -427,6 +1075,12 @@ DataProcessor::GetNoneAiAction(json& action)
   //overwrite by others.
 }
 
+uint32_t
+DataProcessor::GetVerbosity () const
+{
+  return m_verbosity;
+}
+
 void
 DataProcessor::SetMaxPollTime (int timeMs)
 {
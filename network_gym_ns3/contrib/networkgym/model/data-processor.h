@@ -10,24 +10,58 @@
 #include "ns3/core-module.h"
 #include "json.hpp"
 #include "ns3/southbound-interface.h"
+#include "ns3/measurement-aggregator.h"
+#include "ns3/action-dispatcher.h"
+#include "ns3/in-process-policy.h"
+#include "ns3/measurement-recorder.h"
+#include "ns3/measurement-replay.h"
+#include "ns3/measurement-delta.h"
+#include <deque>
+#include <span>
 using json = nlohmann::json;
 namespace ns3 {
+/*
+Network stats of one source at one timestamp. The values are stored in one typed column per metric name and turned
+into json only when GetJson is called. A NetworkStats can be kept across steps and refilled after Reset(ts), the
+columns keep their capacity.
+*/
 class NetworkStats : public Object
 {
 public:
+  struct Metric
+  {
+    std::string name;
+    std::vector<uint64_t> ids;
+    std::vector<double> values; //used while all values are doubles.
+    std::vector<json> jsonValues; //used once a non double value is appended.
+    bool isJson = false;
+  };
+
   NetworkStats (std::string source, uint64_t id, uint64_t ts);
+  NetworkStats (std::string source);
   virtual ~NetworkStats ();
 
   void Append(std::string name, double value);//append a double measurement.
   void Append(std::string name, json& value);//append a json measurement.
   void Append(std::string name, std::string indexName, std::vector<int> indexList, std::vector<double> list);//append a list of double measurement
 
-  json GetJson();
+  void Append(const std::string& name, std::span<const uint64_t> ids, std::span<const double> values);//append one value per id, same layout as the merged network stats.
+
+  void Reset(uint64_t ts);//drop the values and start a new step at ts. The metrics keep their capacity.
+
+  const std::string& GetSource() const;
+  uint64_t GetTs() const;
+  const std::vector<Metric>& GetMetrics() const;
+  std::vector<Metric>& TakeMetrics();//the values can be moved out of the metrics, the measurement is Reset before the next step.
+  const json& GetJson() const;
 private:
+  Metric& GetMetric(const std::string& name);
   std::string m_source;
   uint64_t m_id;
   uint64_t m_ts;
-  json m_data;
+  std::vector<Metric> m_metrics; //in the order the names are first appended.
+  mutable json m_data; //built from m_metrics by GetJson.
+  mutable bool m_dataValid = false;
 };
 
 class DataProcessor : public Object
@@ -42,29 +76,106 @@ public:
   static TypeId GetTypeId (void);
   void StartMeasurement ();
   bool IsMeasurementStarted ();
-  void AppendMeasurement(Ptr<NetworkStats> measurement);//the measurements appended from multiple sources at the same time will be aggregated and sent after 1 nanosecond.
+  void AppendMeasurement(Ptr<NetworkStats> measurement);//the measurements appended from multiple sources at the same time will be aggregated and sent after 1 nanosecond. The double values are taken from the measurement, Reset it for the next step.
+  bool IsSubscribed(std::string_view source, std::string_view name) const;//check before building a measurement, unsubscribed measurements are dropped anyway.
   typedef Callback<void, const json& > NetworkGymActionCallback;
   void SetNetworkGymActionCallback(std::string name, uint64_t id, NetworkGymActionCallback cb);
+  typedef Callback<void, const json&, const json& > NetworkGymBulkActionCallback;
+  void SetNetworkGymBulkActionCallback(std::string name, NetworkGymBulkActionCallback cb); //one call per action entry with its id and value lists.
   void SetMaxPollTime (int timeMs);
+  void SetPolicy (Ptr<InProcessPolicy> policy); //run the policy in-process instead of connecting to the server, set before the measurement starts.
+  uint32_t GetVerbosity () const; //the scenario prints its per node diagnostics if the Verbosity attribute is not 0.
 protected:
   Ptr<SouthboundInterface> m_southbound;
   bool m_measurementStarted = false;
-  std::vector<json> m_measurementBatch;
-  std::vector<std::string> m_subscribedMeasurement; //store the measurement list.
+  MeasurementAggregator m_measurementBatch; //merges the measurements appended in the same step.
+  uint32_t m_measurementBatchSize = 0; //number of measurements appended in the same step.
+  std::vector<bool> m_subscribedMeasurement; //indexed by the m_measurementBatch key, true if source::name is in the subscribed list.
 
 private:
   void ExchangeMeasurementAndAction(); //send measurement and get action.
+  void ExchangeNetworkStats(json& networkStats); //send the merged network stats of a step, or batch them, and get the action.
+  void FinishExchange(); //after a measurement is sent, stop at the end of the session or episode, or wait for the actions beyond the lag.
+  void ReplayStep(uint32_t index); //replay mode, exchange the recorded step and schedule the next one at its recorded ts.
+  void CheckReplayAction(const json& actionList, double tsMs); //replay mode, compare the action with the recorded one.
+  void DispatchAction(const json& actionList, double tsMs); //record the action and send it to the callbacks, not in the replay mode.
+  void ReceiveAndApplyAction(); //wait for the action of the oldest pending measurement and send it to the callbacks.
+  void ApplyAction(json& action, double tsMs); //dispatch the action of the measurement at tsMs, the action_steps are queued.
+  void ApplyPolicyAction(const json& networkStats); //get the action of the in-process policy and apply it.
+  void ApplyStepAction(); //batched mode, apply the queued action of this step, or the GetNoneAiAction, between two exchanges.
+  bool ForkEpisodes(); //fork one child per episode from the warmed-up state, return true in the parent after all episodes.
+  json GetWorkloadStats();
+
+  /*
+  Multi-agent mode, configured by "agent_groups" in the env-configure.json. Each group has its own measurement stream,
+  action callbacks and pending actions. The measurements of a step are sent per group, tagged with the group name as
+  "agent", and the actions are routed to the group by their "agent" field. All groups share the southbound socket.
+  The simulation does not wait for the agents: a group with more than m_actionLagSteps pending actions queues its
+  measurements until its actions arrive, the other groups keep exchanging. Only at the end of the session the
+  simulation waits for the queued measurements and the last actions.
+  */
+  struct QueuedMeasurement
+  {
+    double tsMs;
+    json networkStats;
+  };
+  struct AgentGroup
+  {
+    std::string name;
+    std::string source; //empty matches every source.
+    uint64_t minId = 0; //the id range of the group, inclusive.
+    uint64_t maxId = UINT64_MAX;
+    MeasurementAggregator batch;
+    ActionDispatcher actionDispatcher;
+    std::deque<double> pendingActionTsMs;
+    std::deque<QueuedMeasurement> queuedMeasurements; //taken but not sent yet, oldest first.
+    uint64_t measurementCounter = 0; //measurements taken, sent or queued.
+    uint64_t measurementSentCounter = 0;
+  };
+  uint32_t FindAgentGroup(std::string_view source, uint64_t id) const; //return the index of the first matching group.
+  void AppendAgentMeasurement(Ptr<NetworkStats> measurement);
+  void ExchangeAgentMeasurements(); //apply the arrived actions, then queue the measurements of this step and send what the lag allows.
+  void SendAgentMeasurements(AgentGroup& group); //send the queued measurements while the group has at most m_actionLagSteps pending actions.
+  void ReceiveAgentAction(); //wait for the next action of any group and apply it.
+  void ApplyAgentAction(json& action); //dispatch the action to the callbacks of its agent group.
+  std::vector<AgentGroup> m_agentGroups; //empty in the single agent mode.
+  std::unordered_map<std::string, uint32_t> m_agentGroupIndexMap; //group name -> index
+  EventId m_exchangeAgentMeasurementsEvent;
   virtual void AddMoreMeasurement();
   virtual void GetNoneAiAction(json& action);
   EventId m_exchangeMeasurementAndActionEvent;
-  std::map< std::pair< std::string, uint64_t>, NetworkGymActionCallback> m_networkgymActionCallbackMap; //callback that send action to the connected modules. Multiple modules may connects to it. key is the action name
+  Ptr<InProcessPolicy> m_policy; //replaces the southbound interface if set.
+  ActionDispatcher m_actionDispatcher; //callback that send action to the connected modules. Multiple modules may connects to it. key is the action name and id
 
+  uint32_t m_verbosity;
+  PhaseTimer* m_phaseTimer; //owned by the southbound interface.
+  uint64_t m_stepEndUs = 0; //steady clock when the last step finished, 0 before the first step.
   uint64_t m_waitCounter;
   uint64_t m_startSysTimeMs;
   uint64_t m_waitSysTimeMs;
 
   uint64_t m_totalSteps;
+  uint64_t m_stepsPerEpisode;
+  bool m_forkEpisodes = false; //the episodes run one after another in children forked at the measurement start.
+  uint64_t m_episodeEndStep = UINT64_MAX; //in a forked episode, the child stops after sending this many measurements.
+  uint64_t m_measurementSentCounter = 0;
   double m_measurementSentTsMs;
+  uint32_t m_actionLagSteps = 0; //0 waits for the action of each measurement. L keeps simulating until L measurements are waiting for an action.
+  std::deque<double> m_pendingActionTsMs; //ts of the measurements sent without an action yet, oldest first.
+  bool m_sendColumns = false; //binary encoding, the merged columns are sent without building the network stats json.
+  uint32_t m_stepsPerExchange = 1; //K > 1 gathers the measurements of K steps and sends them in one msg, the agent replies once.
+  json m_exchangeNetworkStats = json::array(); //the network stats of the steps gathered since the last exchange.
+  uint32_t m_exchangeSteps = 0; //number of steps in m_exchangeNetworkStats.
+  std::string m_recordPath; //"record_path" in the env-configure.json, empty if the measurements are not recorded.
+  MeasurementRecorder m_recorder; //opened when the measurement starts, i.e., after the fork of the episodes.
+  MeasurementReplay m_replay; //"replay_path" in the env-configure.json.
+  bool m_replayMode = false; //the measurements are replayed from m_replay, the actions are checked and not dispatched.
+  bool m_replayStrict = false; //"replay_strict", an action that differs from the recording is a fatal error.
+  uint64_t m_replayCheckedActions = 0;
+  uint64_t m_replayActionMismatches = 0;
+  MeasurementDelta m_delta; //"delta_network_stats" in the env-configure.json, reported on change to the southbound interface.
+  std::deque<json> m_actionSteps; //the "action_steps" of the last action, one action list per step until the next exchange.
+  double m_actionStepsTsMs = 0; //ts of the measurement the action steps replied to.
 };
 
 }
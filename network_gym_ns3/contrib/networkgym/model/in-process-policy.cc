@@ -0,0 +1,86 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "in-process-policy.h"
+#include <dlfcn.h>
+using json = nlohmann::json;
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("InProcessPolicy");
+
+NS_OBJECT_ENSURE_REGISTERED (InProcessPolicy);
+
+TypeId
+InProcessPolicy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::InProcessPolicy")
+    .SetParent<Object> ()
+    .SetGroupName("networkgym")
+  ;
+  return tid;
+}
+
+InProcessPolicy::InProcessPolicy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+InProcessPolicy::~InProcessPolicy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+InProcessPolicy::Configure (const json& envConfig)
+{
+  //overwrite by others.
+}
+
+json
+InProcessPolicy::MakeAction (const std::string& source, const std::string& name, double ts,
+                             std::span<const uint64_t> ids, std::span<const double> values)
+{
+  if (ids.size() != values.size())
+  {
+    NS_FATAL_ERROR("The size of the id and value list is not the same!!!");
+  }
+  json entry;
+  entry["source"] = source;
+  entry["name"] = name;
+  entry["ts"] = ts;
+  entry["id"] = json(std::vector<uint64_t>(ids.begin(), ids.end()));
+  entry["value"] = json(std::vector<double>(values.begin(), values.end()));
+  return entry;
+}
+
+Ptr<InProcessPolicy>
+InProcessPolicy::Load (const std::string& path)
+{
+  //never closed, the vtable of the policy lives in the library.
+  void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!handle)
+  {
+    NS_FATAL_ERROR("Cannot load the policy library " << path << ": " << dlerror());
+  }
+  typedef InProcessPolicy* (*Factory) ();
+  Factory factory = reinterpret_cast<Factory>(dlsym(handle, NETWORKGYM_POLICY_FACTORY));
+  if (!factory)
+  {
+    NS_FATAL_ERROR("The policy library " << path << " does not define " << NETWORKGYM_POLICY_FACTORY
+                   << ", see NETWORKGYM_POLICY_PLUGIN.");
+  }
+  InProcessPolicy* policy = factory();
+  if (!policy)
+  {
+    NS_FATAL_ERROR("The policy library " << path << " returned no policy.");
+  }
+  NS_LOG_INFO ("Loaded the policy " << policy->GetInstanceTypeId().GetName() << " from " << path);
+  return Ptr<InProcessPolicy>(policy, false); //adopt the reference taken by the factory.
+}
+
+}
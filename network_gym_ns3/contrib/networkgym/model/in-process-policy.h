@@ -0,0 +1,52 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef IN_PROCESS_POLICY_H
+#define IN_PROCESS_POLICY_H
+
+#include "ns3/core-module.h"
+#include "json.hpp"
+#include <span>
+using json = nlohmann::json;
+namespace ns3 {
+
+/*
+A policy that runs inside the simulator instead of a networkgym client. The data processor hands it the merged network
+stats of each step, the same list of {"source", "name", "ts", "id":[], "value":[]} entries the server mode sends, and
+dispatches the returned action list right away. No msg is serialized and the southbound interface is not connected.
+
+A policy is set by DataProcessor::SetPolicy, or loaded from the shared library named by "policy_library" in the
+env-configure.json. The library defines its factory with NETWORKGYM_POLICY_PLUGIN (MyPolicy), e.g., to wrap a
+TorchScript or ONNX model that the module itself does not link.
+*/
+class InProcessPolicy : public Object
+{
+public:
+  InProcessPolicy ();
+  virtual ~InProcessPolicy ();
+  static TypeId GetTypeId (void);
+
+  virtual void Configure (const json& envConfig); //called with the env-configure.json when loaded from a library.
+  virtual void GetAction (const json& networkStats, double ts, json& actionList) = 0; //append the action entries, their ts must be ts.
+
+  static json MakeAction (const std::string& source, const std::string& name, double ts,
+                          std::span<const uint64_t> ids, std::span<const double> values); //one action list entry.
+  static Ptr<InProcessPolicy> Load (const std::string& path); //dlopen the library and create its policy. The library stays loaded.
+};
+
+}
+
+//the factory symbol looked up by InProcessPolicy::Load, returns a policy with one reference owned by the caller.
+#define NETWORKGYM_POLICY_FACTORY "NetworkGymCreatePolicy"
+#define NETWORKGYM_POLICY_PLUGIN(type)                                  \
+  extern "C" ns3::InProcessPolicy* NetworkGymCreatePolicy ()            \
+  {                                                                     \
+    ns3::Ptr<type> policy = ns3::CreateObject<type> ();                 \
+    policy->Ref ();                                                     \
+    return ns3::PeekPointer (policy);                                   \
+  }
+
+#endif /* IN_PROCESS_POLICY_H */
@@ -0,0 +1,314 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "measurement-aggregator.h"
+#include <numeric>
+
+namespace ns3 {
+
+MeasurementAggregator::MeasurementAggregator ()
+{
+}
+
+uint32_t
+MeasurementAggregator::Intern (std::string_view source, std::string_view name)
+{
+  auto sourceIt = m_keyMap.find(source);
+  if (sourceIt == m_keyMap.end())
+  {
+    sourceIt = m_keyMap.emplace(std::string(source), NameMap()).first;
+  }
+  auto nameIt = sourceIt->second.find(name);
+  if (nameIt != sourceIt->second.end())
+  {
+    return nameIt->second;
+  }
+
+  uint32_t key = m_columns.size();
+  sourceIt->second.emplace(std::string(name), key);
+  Column column;
+  column.source = source;
+  column.name = name;
+  m_columns.push_back(std::move(column));
+  return key;
+}
+
+uint32_t
+MeasurementAggregator::Find (std::string_view source, std::string_view name) const
+{
+  auto sourceIt = m_keyMap.find(source);
+  if (sourceIt == m_keyMap.end())
+  {
+    return INVALID_KEY;
+  }
+  auto nameIt = sourceIt->second.find(name);
+  if (nameIt == sourceIt->second.end())
+  {
+    return INVALID_KEY;
+  }
+  return nameIt->second;
+}
+
+const std::string&
+MeasurementAggregator::GetSource (uint32_t key) const
+{
+  return m_columns.at(key).source;
+}
+
+const std::string&
+MeasurementAggregator::GetName (uint32_t key) const
+{
+  return m_columns.at(key).name;
+}
+
+uint32_t
+MeasurementAggregator::GetNKeys () const
+{
+  return m_columns.size();
+}
+
+MeasurementAggregator::Column&
+MeasurementAggregator::Activate (uint32_t key, uint64_t ts)
+{
+  Column& column = m_columns[key];
+  if (column.ids.empty())
+  {
+    column.ts = ts;
+    m_activeKeys.push_back(key);
+  }
+  else if (column.ts != ts)
+  {
+    NS_FATAL_ERROR("the timestamp of two measurements are different!");
+  }
+  return column;
+}
+
+void
+MeasurementAggregator::Append (const json& measurement)
+{
+  Append(Intern(measurement["source"].get_ref<const std::string&>(), measurement["name"].get_ref<const std::string&>()), measurement);
+}
+
+void
+MeasurementAggregator::Append (uint32_t key, const json& measurement)
+{
+  uint64_t ts = measurement["ts"].get<uint64_t>();
+  const json& ids = measurement["id"];
+  const json& values = measurement["value"];
+  if (ids.size() != values.size())
+  {
+    NS_FATAL_ERROR("The size of the id and value list is not the same!!!");
+  }
+  for (uint32_t i = 0; i < ids.size(); i++)
+  {
+    Append(key, ts, ids[i].get<uint64_t>(), values[i]);
+  }
+}
+
+void
+MeasurementAggregator::Append (uint32_t key, uint64_t ts, uint64_t id, double value)
+{
+  Column& column = Activate(key, ts);
+  column.ids.push_back(id);
+  if (column.isJson)
+  {
+    column.jsonValues.push_back(value);
+  }
+  else
+  {
+    column.values.push_back(value);
+  }
+}
+
+void
+MeasurementAggregator::Append (uint32_t key, uint64_t ts, uint64_t id, const json& value)
+{
+  if (value.is_number_float())
+  {
+    Append(key, ts, id, value.get<double>());
+    return;
+  }
+
+  Column& column = Activate(key, ts);
+  if (!column.isJson)
+  {
+    //switch this column to json values, e.g., integers or nested lists appended through the json interface.
+    column.jsonValues.assign(column.values.begin(), column.values.end());
+    column.values.clear();
+    column.isJson = true;
+  }
+  column.ids.push_back(id);
+  column.jsonValues.push_back(value);
+}
+
+void
+MeasurementAggregator::Append (uint32_t key, uint64_t ts, std::span<const uint64_t> ids, std::span<const double> values)
+{
+  if (ids.size() != values.size())
+  {
+    NS_FATAL_ERROR("The size of the id and value list is not the same!!!");
+  }
+  if (ids.empty())
+  {
+    return;
+  }
+  Column& column = Activate(key, ts);
+  column.ids.insert(column.ids.end(), ids.begin(), ids.end());
+  if (column.isJson)
+  {
+    column.jsonValues.insert(column.jsonValues.end(), values.begin(), values.end());
+  }
+  else
+  {
+    column.values.insert(column.values.end(), values.begin(), values.end());
+  }
+}
+
+void
+MeasurementAggregator::Append (uint32_t key, uint64_t ts, std::vector<uint64_t>&& ids, std::vector<double>&& values)
+{
+  if (ids.size() != values.size())
+  {
+    NS_FATAL_ERROR("The size of the id and value list is not the same!!!");
+  }
+  if (ids.empty())
+  {
+    return;
+  }
+  if (!m_columns[key].ids.empty())
+  {
+    //merged with the values of another measurement of this step.
+    Append(key, ts, std::span<const uint64_t>(ids), std::span<const double>(values));
+    return;
+  }
+  //the only values of this key so far, they are swapped in. The caller gets the cleared vectors of the column back,
+  //both sides keep their capacity across steps. Sorted ids are not reordered at Flush.
+  Column& column = Activate(key, ts);
+  column.ids.swap(ids);
+  column.values.swap(values);
+}
+
+void
+MeasurementAggregator::Append (uint32_t key, uint64_t ts, std::span<const uint64_t> ids, std::span<const json> values)
+{
+  if (ids.size() != values.size())
+  {
+    NS_FATAL_ERROR("The size of the id and value list is not the same!!!");
+  }
+  for (uint32_t i = 0; i < ids.size(); i++)
+  {
+    Append(key, ts, ids[i], values[i]);
+  }
+}
+
+bool
+MeasurementAggregator::IsEmpty () const
+{
+  return m_activeKeys.empty();
+}
+
+void
+MeasurementAggregator::SortById (Column& column)
+{
+  if (std::is_sorted(column.ids.begin(), column.ids.end()))
+  {
+    return;
+  }
+  //stable, such that values with the same id keep the order they were appended in.
+  m_order.resize(column.ids.size());
+  std::iota(m_order.begin(), m_order.end(), 0);
+  std::stable_sort(m_order.begin(), m_order.end(), [&column](uint32_t a, uint32_t b) { return column.ids[a] < column.ids[b]; });
+
+  std::vector<uint64_t> ids(column.ids.size());
+  for (uint32_t i = 0; i < m_order.size(); i++)
+  {
+    ids[i] = column.ids[m_order[i]];
+  }
+  column.ids.swap(ids);
+  if (column.isJson)
+  {
+    std::vector<json> values(column.jsonValues.size());
+    for (uint32_t i = 0; i < m_order.size(); i++)
+    {
+      values[i] = std::move(column.jsonValues[m_order[i]]);
+    }
+    column.jsonValues.swap(values);
+  }
+  else
+  {
+    std::vector<double> values(column.values.size());
+    for (uint32_t i = 0; i < m_order.size(); i++)
+    {
+      values[i] = column.values[m_order[i]];
+    }
+    column.values.swap(values);
+  }
+}
+
+void
+MeasurementAggregator::Sort ()
+{
+  for (uint32_t key : m_activeKeys)
+  {
+    SortById(m_columns[key]);
+  }
+}
+
+const std::vector<uint32_t>&
+MeasurementAggregator::GetActiveKeys () const
+{
+  return m_activeKeys;
+}
+
+const MeasurementAggregator::Column&
+MeasurementAggregator::GetColumn (uint32_t key) const
+{
+  return m_columns.at(key);
+}
+
+json
+MeasurementAggregator::Flush ()
+{
+  Sort();
+  json networkStats;
+  for (uint32_t key : m_activeKeys)
+  {
+    Column& column = m_columns[key];
+    json measurement;
+    measurement["source"] = column.source;
+    measurement["id"] = column.ids;
+    measurement["ts"] = column.ts;
+    measurement["name"] = column.name;
+    if (column.isJson)
+    {
+      measurement["value"] = std::move(column.jsonValues);
+    }
+    else
+    {
+      measurement["value"] = column.values;
+    }
+    networkStats.push_back(std::move(measurement));
+  }
+  Clear();
+  return networkStats;
+}
+
+void
+MeasurementAggregator::Clear ()
+{
+  for (uint32_t key : m_activeKeys)
+  {
+    Column& column = m_columns[key];
+    column.ids.clear();
+    column.values.clear();
+    column.jsonValues.clear();
+    column.isJson = false;
+  }
+  m_activeKeys.clear();
+}
+
+}
@@ -0,0 +1,79 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef MEASUREMENT_AGGREGATOR_H
+#define MEASUREMENT_AGGREGATOR_H
+
+#include "ns3/core-module.h"
+#include "json.hpp"
+#include <span>
+#include <string_view>
+#include <unordered_map>
+using json = nlohmann::json;
+namespace ns3 {
+
+/*
+Merge the network stats appended during one step. Every (source, name) pair is interned into a dense key the first
+time it is seen; the ids and values of a key are gathered into contiguous vectors and sorted by id once at Flush.
+*/
+class MeasurementAggregator
+{
+public:
+  MeasurementAggregator ();
+
+  static constexpr uint32_t INVALID_KEY = UINT32_MAX;
+  uint32_t Intern (std::string_view source, std::string_view name); //return the dense key of the source and name pair.
+  uint32_t Find (std::string_view source, std::string_view name) const; //return INVALID_KEY if the pair is not interned.
+  const std::string& GetSource (uint32_t key) const;
+  const std::string& GetName (uint32_t key) const;
+  uint32_t GetNKeys () const;
+
+  void Append (const json& measurement); //append one network stats entry, i.e., {"source", "name", "ts", "id":[], "value":[]}.
+  void Append (uint32_t key, const json& measurement); //same as above, the key of the source and name is already known.
+  void Append (uint32_t key, uint64_t ts, uint64_t id, double value);
+  void Append (uint32_t key, uint64_t ts, uint64_t id, const json& value);
+  void Append (uint32_t key, uint64_t ts, std::span<const uint64_t> ids, std::span<const double> values); //append a column of values.
+  void Append (uint32_t key, uint64_t ts, std::vector<uint64_t>&& ids, std::vector<double>&& values); //same as above, the vectors are taken without a copy if the key has no data in this step.
+  void Append (uint32_t key, uint64_t ts, std::span<const uint64_t> ids, std::span<const json> values);
+
+  struct Column
+  {
+    std::string source;
+    std::string name;
+    uint64_t ts = 0;
+    std::vector<uint64_t> ids;
+    std::vector<double> values; //used while all values are doubles.
+    std::vector<json> jsonValues; //used once a non double value is appended.
+    bool isJson = false;
+  };
+
+  bool IsEmpty () const;
+  json Flush (); //return the merged network stats and clear the batch. The interned keys and the vector capacity are kept.
+  void Clear ();
+  void Sort (); //sort the columns of this step by id, e.g., before they are read without Flush.
+  const std::vector<uint32_t>& GetActiveKeys () const; //keys with data in this step, in the order they are first seen.
+  const Column& GetColumn (uint32_t key) const;
+
+private:
+  struct StringHash
+  {
+    using is_transparent = void;
+    size_t operator() (std::string_view s) const { return std::hash<std::string_view>{} (s); }
+  };
+  typedef std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> NameMap;
+
+  Column& Activate (uint32_t key, uint64_t ts); //add the key to the active list of this step and check the ts.
+  void SortById (Column& column);
+
+  std::unordered_map<std::string, NameMap, StringHash, std::equal_to<>> m_keyMap; //source -> name -> key
+  std::vector<Column> m_columns; //indexed by key
+  std::vector<uint32_t> m_activeKeys; //keys with data in this step, in the order they are first seen.
+  std::vector<uint32_t> m_order; //scratch buffer for sorting
+};
+
+}
+
+#endif /* MEASUREMENT_AGGREGATOR_H */
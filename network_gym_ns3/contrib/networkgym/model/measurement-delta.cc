@@ -0,0 +1,109 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "measurement-delta.h"
+#include "ns3/core-module.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MeasurementDelta");
+
+MeasurementDelta::MeasurementDelta ()
+  : m_keyframeSteps (100),
+    m_stepsSinceKeyframe (0),
+    m_keyframeNext (true),
+    m_omittedValues (0)
+{
+}
+
+void
+MeasurementDelta::Add (const std::string& sourceAndName)
+{
+  m_lastSent[sourceAndName];
+}
+
+void
+MeasurementDelta::SetKeyframeSteps (uint32_t steps)
+{
+  m_keyframeSteps = steps;
+}
+
+bool
+MeasurementDelta::IsEnabled () const
+{
+  return !m_lastSent.empty();
+}
+
+void
+MeasurementDelta::Encode (json& networkStats)
+{
+  bool keyframe = m_keyframeNext || (m_keyframeSteps > 0 && m_stepsSinceKeyframe >= m_keyframeSteps);
+  m_keyframeNext = false;
+  m_stepsSinceKeyframe = keyframe ? 1 : m_stepsSinceKeyframe + 1;
+
+  for (auto& entry : networkStats)
+  {
+    auto it = m_lastSent.find(entry["source"].get_ref<const std::string&>() + "::" + entry["name"].get_ref<const std::string&>());
+    if (it == m_lastSent.end())
+    {
+      continue;
+    }
+    Values& lastSent = it->second;
+    const json& ids = entry["id"];
+    const json& values = entry["value"];
+
+    bool full = keyframe;
+    if (!full)
+    {
+      //a removed id needs a full entry, the ids are unique within an entry.
+      size_t known = 0;
+      for (const auto& id : ids)
+      {
+        known += lastSent.count(id.get<uint64_t>());
+      }
+      full = known < lastSent.size();
+    }
+
+    if (full)
+    {
+      lastSent.clear();
+      for (size_t i = 0; i < ids.size(); i++)
+      {
+        lastSent.emplace(ids[i].get<uint64_t>(), values[i]);
+      }
+      entry["delta"] = false;
+      continue;
+    }
+
+    json changedIds = json::array();
+    json changedValues = json::array();
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+      auto [valueIt, inserted] = lastSent.try_emplace(ids[i].get<uint64_t>(), values[i]);
+      if (!inserted && valueIt->second == values[i])
+      {
+        m_omittedValues++;
+        continue;
+      }
+      valueIt->second = values[i];
+      changedIds.push_back(ids[i]);
+      changedValues.push_back(values[i]);
+    }
+    entry["id"] = std::move(changedIds);
+    entry["value"] = std::move(changedValues);
+    entry["delta"] = true;
+  }
+  NS_LOG_INFO ((keyframe ? "keyframe, " : "delta, ") << m_omittedValues << " values omitted so far");
+}
+
+uint64_t
+MeasurementDelta::GetOmittedValues () const
+{
+  return m_omittedValues;
+}
+
+}
@@ -0,0 +1,49 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef MEASUREMENT_DELTA_H
+#define MEASUREMENT_DELTA_H
+
+#include "json.hpp"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+using json = nlohmann::json;
+namespace ns3 {
+
+/*
+On-change reporting of slowly varying metrics, e.g., the node positions or the RX power matrix of static nodes. The
+entries of the selected source::name keep only the ids whose value changed since the last sent step and carry
+"delta": true. A keyframe sends every id with "delta": false, the client resets its copy of the metric and fills the
+ids omitted by the next delta entries from it (see NorthBoundClient.fill_delta).
+
+A keyframe is sent every KeyframeSteps steps, at the first step after the fork of an episode, and for a metric whose
+ids changed, since a delta entry cannot express a removed id.
+*/
+class MeasurementDelta
+{
+public:
+  MeasurementDelta ();
+
+  void Add (const std::string& sourceAndName); //report source::name on change, e.g., "Obss::Cpp2Py::NodeX".
+  void SetKeyframeSteps (uint32_t steps); //0 sends a keyframe only at the first step.
+  bool IsEnabled () const;
+  void Encode (json& networkStats); //drop the unchanged values of one step of merged network stats in place.
+  uint64_t GetOmittedValues () const; //number of values omitted so far.
+
+private:
+  typedef std::map<uint64_t, json> Values; //id -> last sent value
+  std::unordered_map<std::string, Values> m_lastSent; //source::name -> values, only the selected metrics.
+  uint32_t m_keyframeSteps;
+  uint32_t m_stepsSinceKeyframe;
+  bool m_keyframeNext; //the next step is a keyframe.
+  uint64_t m_omittedValues;
+};
+
+}
+
+#endif /* MEASUREMENT_DELTA_H */
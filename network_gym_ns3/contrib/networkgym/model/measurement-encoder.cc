@@ -0,0 +1,284 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "measurement-encoder.h"
+#include <algorithm>
+#include <bit>
+
+namespace ns3 {
+
+MeasurementEncoder::MeasurementEncoder ()
+  : m_cbor (false),
+    m_out (nullptr),
+    m_schemaBatch (nullptr)
+{
+}
+
+void
+MeasurementEncoder::SetCbor (bool cbor)
+{
+  m_cbor = cbor;
+}
+
+uint32_t
+MeasurementEncoder::GetSchemaId (const std::string& source, const std::string& name, json& schema)
+{
+  uint32_t nKeys = m_schemaKeys.GetNKeys();
+  uint32_t schemaId = m_schemaKeys.Intern(source, name);
+  if (schemaId >= nKeys)
+  {
+    json item;
+    item["schema_id"] = schemaId;
+    item["source"] = source;
+    item["name"] = name;
+    schema.push_back(std::move(item));
+  }
+  return schemaId;
+}
+
+void
+MeasurementEncoder::Encode (MeasurementAggregator& batch, json& schema, std::string& out)
+{
+  if (m_schemaBatch != &batch)
+  {
+    //the cached schema ids are keyed by the batch keys, they are looked up again for another batch.
+    m_schemaBatch = &batch;
+    m_batchSchemaIds.clear();
+  }
+  m_out = &out;
+  batch.Sort();
+  const std::vector<uint32_t>& keys = batch.GetActiveKeys();
+  WriteArray(keys.size());
+  for (uint32_t key : keys)
+  {
+    if (key >= m_batchSchemaIds.size())
+    {
+      m_batchSchemaIds.resize(key + 1, MeasurementAggregator::INVALID_KEY);
+    }
+    if (m_batchSchemaIds[key] == MeasurementAggregator::INVALID_KEY)
+    {
+      m_batchSchemaIds[key] = GetSchemaId(batch.GetSource(key), batch.GetName(key), schema);
+    }
+
+    const MeasurementAggregator::Column& column = batch.GetColumn(key);
+    WriteArray(4);
+    WriteUnsigned(m_batchSchemaIds[key]);
+    WriteUnsigned(column.ts);
+    WriteArray(column.ids.size());
+    for (uint64_t id : column.ids)
+    {
+      WriteUnsigned(id);
+    }
+    if (column.isJson)
+    {
+      WriteArray(column.jsonValues.size());
+      for (const auto& value : column.jsonValues)
+      {
+        WriteValue(value);
+      }
+    }
+    else
+    {
+      WriteDoubles(column.values);
+    }
+  }
+  m_out = nullptr;
+}
+
+void
+MeasurementEncoder::Encode (const json& networkStats, json& schema, std::string& out)
+{
+  m_out = &out;
+  WriteArray(networkStats.size());
+  for (const auto& entry : networkStats)
+  {
+    const json& ids = entry["id"];
+    const json& values = entry["value"];
+    bool hasDelta = entry.contains("delta"); //on-change reporting, see MeasurementDelta.
+    WriteArray(hasDelta ? 5 : 4);
+    WriteUnsigned(GetSchemaId(entry["source"].get_ref<const std::string&>(), entry["name"].get_ref<const std::string&>(), schema));
+    WriteUnsigned(entry["ts"].get<uint64_t>());
+    WriteArray(ids.size());
+    for (const auto& id : ids)
+    {
+      WriteUnsigned(id.get<uint64_t>());
+    }
+    if (std::all_of(values.begin(), values.end(), [](const json& v) { return v.is_number_float(); }))
+    {
+      WriteBytesHead(values.size() * sizeof(double));
+      for (const auto& value : values)
+      {
+        double v = value.get<double>();
+        out.append(reinterpret_cast<const char*>(&v), sizeof(double));
+      }
+    }
+    else
+    {
+      WriteArray(values.size());
+      for (const auto& value : values)
+      {
+        WriteValue(value);
+      }
+    }
+    if (hasDelta)
+    {
+      WriteBool(entry["delta"].get<bool>());
+    }
+  }
+  m_out = nullptr;
+}
+
+void
+MeasurementEncoder::WriteBigEndian (uint64_t value, uint32_t bytes)
+{
+  for (uint32_t i = bytes; i > 0; i--)
+  {
+    m_out->push_back(static_cast<char>(value >> (8 * (i - 1))));
+  }
+}
+
+void
+MeasurementEncoder::WriteHead (uint8_t major, uint64_t n)
+{
+  uint8_t type = major << 5;
+  if (n < 24)
+  {
+    m_out->push_back(static_cast<char>(type | n));
+  }
+  else if (n <= UINT8_MAX)
+  {
+    m_out->push_back(static_cast<char>(type | 24));
+    WriteBigEndian(n, 1);
+  }
+  else if (n <= UINT16_MAX)
+  {
+    m_out->push_back(static_cast<char>(type | 25));
+    WriteBigEndian(n, 2);
+  }
+  else if (n <= UINT32_MAX)
+  {
+    m_out->push_back(static_cast<char>(type | 26));
+    WriteBigEndian(n, 4);
+  }
+  else
+  {
+    m_out->push_back(static_cast<char>(type | 27));
+    WriteBigEndian(n, 8);
+  }
+}
+
+void
+MeasurementEncoder::WriteArray (uint64_t n)
+{
+  if (m_cbor)
+  {
+    WriteHead(4, n);
+  }
+  else if (n < 16)
+  {
+    m_out->push_back(static_cast<char>(0x90 | n)); //fixarray
+  }
+  else if (n <= UINT16_MAX)
+  {
+    m_out->push_back(static_cast<char>(0xdc));
+    WriteBigEndian(n, 2);
+  }
+  else
+  {
+    m_out->push_back(static_cast<char>(0xdd));
+    WriteBigEndian(n, 4);
+  }
+}
+
+void
+MeasurementEncoder::WriteUnsigned (uint64_t value)
+{
+  if (m_cbor)
+  {
+    WriteHead(0, value);
+  }
+  else if (value < 128)
+  {
+    m_out->push_back(static_cast<char>(value)); //positive fixint
+  }
+  else if (value <= UINT8_MAX)
+  {
+    m_out->push_back(static_cast<char>(0xcc));
+    WriteBigEndian(value, 1);
+  }
+  else if (value <= UINT16_MAX)
+  {
+    m_out->push_back(static_cast<char>(0xcd));
+    WriteBigEndian(value, 2);
+  }
+  else if (value <= UINT32_MAX)
+  {
+    m_out->push_back(static_cast<char>(0xce));
+    WriteBigEndian(value, 4);
+  }
+  else
+  {
+    m_out->push_back(static_cast<char>(0xcf));
+    WriteBigEndian(value, 8);
+  }
+}
+
+void
+MeasurementEncoder::WriteBool (bool value)
+{
+  if (m_cbor)
+  {
+    m_out->push_back(static_cast<char>(value ? 0xf5 : 0xf4));
+  }
+  else
+  {
+    m_out->push_back(static_cast<char>(value ? 0xc3 : 0xc2));
+  }
+}
+
+void
+MeasurementEncoder::WriteBytesHead (uint64_t n)
+{
+  if (m_cbor)
+  {
+    WriteHead(2, n);
+  }
+  else if (n <= UINT8_MAX)
+  {
+    m_out->push_back(static_cast<char>(0xc4));
+    WriteBigEndian(n, 1);
+  }
+  else if (n <= UINT16_MAX)
+  {
+    m_out->push_back(static_cast<char>(0xc5));
+    WriteBigEndian(n, 2);
+  }
+  else
+  {
+    m_out->push_back(static_cast<char>(0xc6));
+    WriteBigEndian(n, 4);
+  }
+}
+
+void
+MeasurementEncoder::WriteDoubles (std::span<const double> values)
+{
+  static_assert(std::endian::native == std::endian::little, "the value columns are sent as little-endian float64");
+  //the client reads them with numpy.frombuffer.
+  WriteBytesHead(values.size_bytes());
+  m_out->append(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+}
+
+void
+MeasurementEncoder::WriteValue (const json& value)
+{
+  //e.g., integers or nested lists appended through the json interface, not on the hot path.
+  std::vector<std::uint8_t> encoded = m_cbor ? json::to_cbor(value) : json::to_msgpack(value);
+  m_out->append(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+}
+
+}
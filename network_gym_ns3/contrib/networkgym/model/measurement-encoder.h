@@ -0,0 +1,55 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef MEASUREMENT_ENCODER_H
+#define MEASUREMENT_ENCODER_H
+
+#include "json.hpp"
+#include "ns3/measurement-aggregator.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+using json = nlohmann::json;
+namespace ns3 {
+
+/*
+Binary network stats frame of the msgpack and cbor encodings, an array with one [schema_id, ts, id list, value list]
+column per entry, plus the delta flag of a MeasurementDelta entry. The double value lists are packed little-endian
+float64 bytes. The frame is written straight into the output string, from the merged columns of a
+MeasurementAggregator or from the network stats json. Every (source, name) pair is interned into a schema id, the new
+ones are added to the schema list of the header so the client receives the strings once per session.
+*/
+class MeasurementEncoder
+{
+public:
+  MeasurementEncoder ();
+
+  void SetCbor (bool cbor); //cbor instead of msgpack.
+  void Encode (MeasurementAggregator& batch, json& schema, std::string& out); //the columns of this step of the batch, sorted by id.
+  void Encode (const json& networkStats, json& schema, std::string& out);
+
+private:
+  uint32_t GetSchemaId (const std::string& source, const std::string& name, json& schema); //intern the pair, and announce a new one in the schema.
+  void WriteArray (uint64_t n);
+  void WriteUnsigned (uint64_t value);
+  void WriteBool (bool value);
+  void WriteDoubles (std::span<const double> values); //packed little-endian float64 bytes.
+  void WriteBytesHead (uint64_t n);
+  void WriteValue (const json& value); //any json value, through the nlohmann encoder.
+  void WriteHead (uint8_t major, uint64_t n); //cbor major type and argument.
+  void WriteBigEndian (uint64_t value, uint32_t bytes);
+
+  bool m_cbor;
+  std::string* m_out; //the frame being written.
+  MeasurementAggregator m_schemaKeys; //(source, name) -> schema id, only the key interning is used.
+  const MeasurementAggregator* m_schemaBatch; //the batch m_batchSchemaIds belongs to.
+  std::vector<uint32_t> m_batchSchemaIds; //batch key -> schema id, INVALID_KEY until the key is seen.
+};
+
+}
+
+#endif /* MEASUREMENT_ENCODER_H */
@@ -0,0 +1,266 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "measurement-recorder.h"
+#include "ns3/core-module.h"
+#include <cerrno>
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MeasurementRecorder");
+
+namespace {
+
+template <class T>
+void
+Put (std::string& buffer, T value)
+{
+  //the supported platforms are little endian, same as the file.
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof value);
+}
+
+void
+PutBytes (std::string& buffer, std::string_view bytes)
+{
+  buffer.append(bytes);
+}
+
+void
+Pad (std::string& buffer)
+{
+  buffer.append((8 - buffer.size() % 8) % 8, '\0');
+}
+
+//write the record header with a placeholder size, FinishRecord sets it.
+size_t
+StartRecord (std::string& buffer, MeasurementRecorder::RecordType type)
+{
+  Put<uint32_t>(buffer, type);
+  Put<uint32_t>(buffer, 0);
+  return buffer.size();
+}
+
+void
+FinishRecord (std::string& buffer, size_t payloadStart)
+{
+  Pad(buffer);
+  uint32_t size = buffer.size() - payloadStart;
+  std::memcpy(&buffer[payloadStart - sizeof size], &size, sizeof size);
+}
+
+bool
+IsDoubleList (const json& values)
+{
+  for (const auto& value : values)
+  {
+    if (!value.is_number())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+MeasurementRecorder::MeasurementRecorder ()
+{
+}
+
+MeasurementRecorder::~MeasurementRecorder ()
+{
+  Close();
+}
+
+void
+MeasurementRecorder::Open (const std::string& path)
+{
+  Close();
+  m_file = std::fopen(path.c_str(), "wb");
+  if (!m_file)
+  {
+    NS_FATAL_ERROR("Cannot create the measurement record " << path << ": " << std::strerror(errno));
+  }
+  m_path = path;
+  m_schemaIdMap.clear();
+  m_closing = false;
+  m_bytesWritten = 0;
+
+  std::string header(MAGIC, sizeof MAGIC);
+  Put<uint32_t>(header, VERSION);
+  Put<uint32_t>(header, 0);
+  m_writer = std::thread(&MeasurementRecorder::Run, this);
+  Push(std::move(header));
+  NS_LOG_INFO ("Recording the measurements to " << path);
+}
+
+bool
+MeasurementRecorder::IsOpen () const
+{
+  return m_file != nullptr;
+}
+
+uint32_t
+MeasurementRecorder::GetSchemaId (std::string_view source, std::string_view name, std::string& buffer)
+{
+  std::string key;
+  key.reserve(source.size() + name.size() + 2);
+  key.append(source).append("::").append(name);
+  auto it = m_schemaIdMap.find(key);
+  if (it != m_schemaIdMap.end())
+  {
+    return it->second;
+  }
+  uint32_t schemaId = m_schemaIdMap.size();
+  m_schemaIdMap.emplace(std::move(key), schemaId);
+
+  size_t payloadStart = StartRecord(buffer, SCHEMA);
+  Put<uint32_t>(buffer, schemaId);
+  Put<uint16_t>(buffer, source.size());
+  Put<uint16_t>(buffer, name.size());
+  PutBytes(buffer, source);
+  PutBytes(buffer, name);
+  FinishRecord(buffer, payloadStart);
+  return schemaId;
+}
+
+void
+MeasurementRecorder::RecordStep (uint64_t step, double tsMs, const json& networkStats)
+{
+  if (!IsOpen())
+  {
+    return;
+  }
+  std::string buffer;
+  //the schema records go first, the step record refers to them.
+  std::vector<uint32_t> schemaIds;
+  schemaIds.reserve(networkStats.size());
+  for (const auto& entry : networkStats)
+  {
+    schemaIds.push_back(GetSchemaId(entry["source"].get_ref<const std::string&>(),
+                                    entry["name"].get_ref<const std::string&>(), buffer));
+  }
+
+  size_t payloadStart = StartRecord(buffer, STEP);
+  Put<uint64_t>(buffer, step);
+  Put<double>(buffer, tsMs);
+  Put<uint32_t>(buffer, networkStats.size());
+  Put<uint32_t>(buffer, 0);
+  for (size_t i = 0; i < networkStats.size(); i++)
+  {
+    const json& entry = networkStats[i];
+    const json& ids = entry["id"];
+    const json& values = entry["value"];
+    bool isDouble = IsDoubleList(values);
+    Put<uint32_t>(buffer, schemaIds[i]);
+    Put<uint32_t>(buffer, isDouble ? DOUBLE : JSON);
+    Put<uint64_t>(buffer, entry["ts"].get<uint64_t>());
+    Put<uint64_t>(buffer, ids.size());
+    for (const auto& id : ids)
+    {
+      Put<uint64_t>(buffer, id.get<uint64_t>());
+    }
+    if (isDouble)
+    {
+      for (const auto& value : values)
+      {
+        Put<double>(buffer, value.get<double>());
+      }
+    }
+    else
+    {
+      std::string text = values.dump();
+      Put<uint64_t>(buffer, text.size());
+      PutBytes(buffer, text);
+      Pad(buffer);
+    }
+  }
+  FinishRecord(buffer, payloadStart);
+  Push(std::move(buffer));
+}
+
+void
+MeasurementRecorder::RecordAction (uint64_t step, double tsMs, const json& actionList)
+{
+  if (!IsOpen())
+  {
+    return;
+  }
+  std::string buffer;
+  size_t payloadStart = StartRecord(buffer, ACTION);
+  Put<uint64_t>(buffer, step);
+  Put<double>(buffer, tsMs);
+  std::string text = actionList.dump();
+  Put<uint64_t>(buffer, text.size());
+  PutBytes(buffer, text);
+  FinishRecord(buffer, payloadStart);
+  Push(std::move(buffer));
+}
+
+void
+MeasurementRecorder::Push (std::string&& buffer)
+{
+  m_bytesWritten += buffer.size();
+  std::unique_lock<std::mutex> lock(m_mutex);
+  //backpressure, a slow disk slows the simulation down instead of growing the queue without bound.
+  m_cv.wait(lock, [this] { return m_pendingBytes < MAX_PENDING_BYTES; });
+  m_pendingBytes += buffer.size();
+  m_queue.push_back(std::move(buffer));
+  lock.unlock();
+  m_cv.notify_all();
+}
+
+void
+MeasurementRecorder::Run ()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true)
+  {
+    m_cv.wait(lock, [this] { return m_closing || !m_queue.empty(); });
+    if (m_queue.empty())
+    {
+      break; //closing and everything is written.
+    }
+    std::string buffer = std::move(m_queue.front());
+    m_queue.pop_front();
+    lock.unlock();
+    if (std::fwrite(buffer.data(), 1, buffer.size(), m_file) != buffer.size())
+    {
+      NS_FATAL_ERROR("Cannot write the measurement record " << m_path << ": " << std::strerror(errno));
+    }
+    lock.lock();
+    m_pendingBytes -= buffer.size();
+    m_cv.notify_all();
+  }
+}
+
+void
+MeasurementRecorder::Close ()
+{
+  if (!IsOpen())
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closing = true;
+  }
+  m_cv.notify_all();
+  m_writer.join();
+  std::fclose(m_file);
+  m_file = nullptr;
+  NS_LOG_INFO ("Recorded " << m_bytesWritten << " bytes to " << m_path);
+}
+
+uint64_t
+MeasurementRecorder::GetBytesWritten () const
+{
+  return m_bytesWritten;
+}
+
+}
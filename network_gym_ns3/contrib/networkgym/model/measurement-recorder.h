@@ -0,0 +1,90 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef MEASUREMENT_RECORDER_H
+#define MEASUREMENT_RECORDER_H
+
+#include "json.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+using json = nlohmann::json;
+namespace ns3 {
+
+/*
+Append-only recording of the merged network stats of each step and of the applied actions. The records are encoded in
+the simulation thread and written by a background thread, the simulation only blocks if MAX_PENDING_BYTES are queued.
+
+The file is little endian and every field is 8 byte aligned, such that a reader can memory-map it and view the id and
+value columns in place (see network_gym_client/measurement_reader.py):
+  file header: "NGYMREC\0", uint32 version, uint32 0
+  record: uint32 type, uint32 payload bytes, payload padded to 8 bytes
+    SCHEMA: uint32 schema id, uint16 source size, uint16 name size, source, name
+    STEP: uint64 step, double ts (ms), uint32 column count, uint32 0, then per column:
+          uint32 schema id, uint32 value type, uint64 ts, uint64 n, n uint64 ids, then
+          DOUBLE: n doubles, JSON: uint64 size and the json text of the value list
+    ACTION: uint64 steps recorded before the action, double ts (ms) of its measurement, uint64 size, json text of the
+            action list
+A schema record is written before the first step that uses it.
+*/
+class MeasurementRecorder
+{
+public:
+  enum RecordType : uint32_t
+  {
+    SCHEMA = 1,
+    STEP = 2,
+    ACTION = 3
+  };
+  enum ValueType : uint32_t
+  {
+    DOUBLE = 0,
+    JSON = 1
+  };
+  static constexpr char MAGIC[8] = {'N', 'G', 'Y', 'M', 'R', 'E', 'C', '\0'};
+  static constexpr uint32_t VERSION = 1;
+  static constexpr uint64_t MAX_PENDING_BYTES = 64 << 20; //the simulation waits for the writer above this.
+
+  MeasurementRecorder ();
+  ~MeasurementRecorder (); //calls Close.
+
+  MeasurementRecorder (const MeasurementRecorder&) = delete;
+  MeasurementRecorder& operator= (const MeasurementRecorder&) = delete;
+
+  void Open (const std::string& path); //create the file and start the writer thread, NS_FATAL_ERROR if it cannot be created.
+  bool IsOpen () const;
+  void RecordStep (uint64_t step, double tsMs, const json& networkStats); //the merged entries, i.e., {"source", "name", "ts", "id":[], "value":[]}.
+  void RecordAction (uint64_t step, double tsMs, const json& actionList);
+  void Close (); //write the queued records and stop the writer thread.
+  uint64_t GetBytesWritten () const; //bytes handed to the writer, including the queued ones.
+
+private:
+  uint32_t GetSchemaId (std::string_view source, std::string_view name, std::string& buffer); //append the schema record if new.
+  void Push (std::string&& buffer);
+  void Run (); //writer thread.
+
+  std::FILE* m_file = nullptr;
+  std::unordered_map<std::string, uint32_t> m_schemaIdMap; //source::name -> schema id
+  std::string m_path;
+  uint64_t m_bytesWritten = 0;
+
+  std::thread m_writer;
+  std::mutex m_mutex;
+  std::condition_variable m_cv; //notifies the writer of new records, and the producer of free space.
+  std::deque<std::string> m_queue; //encoded records, guarded by m_mutex.
+  uint64_t m_pendingBytes = 0; //guarded by m_mutex.
+  bool m_closing = false; //guarded by m_mutex.
+};
+
+}
+
+#endif /* MEASUREMENT_RECORDER_H */
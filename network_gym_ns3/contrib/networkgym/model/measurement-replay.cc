@@ -0,0 +1,159 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "measurement-replay.h"
+#include "measurement-recorder.h"
+#include "ns3/core-module.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MeasurementReplay");
+
+MeasurementReplay::MeasurementReplay ()
+{
+}
+
+template <class T>
+T
+MeasurementReplay::Get (size_t offset) const
+{
+  if (offset + sizeof(T) > m_data.size())
+  {
+    NS_FATAL_ERROR("The measurement record " << m_path << " is truncated at " << offset);
+  }
+  T value;
+  std::memcpy(&value, &m_data[offset], sizeof value);
+  return value;
+}
+
+void
+MeasurementReplay::Open (const std::string& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+  {
+    NS_FATAL_ERROR("Cannot open the measurement record " << path);
+  }
+  m_path = path;
+  m_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  if (m_data.size() < 16 || std::memcmp(m_data.data(), MeasurementRecorder::MAGIC, sizeof MeasurementRecorder::MAGIC) != 0)
+  {
+    NS_FATAL_ERROR(path << " is not a measurement record.");
+  }
+  if (Get<uint32_t>(8) != MeasurementRecorder::VERSION)
+  {
+    NS_FATAL_ERROR("Unsupported measurement record version " << Get<uint32_t>(8) << " of " << path);
+  }
+
+  m_schema.clear();
+  m_steps.clear();
+  m_actions.clear();
+  size_t offset = 16;
+  while (offset + 8 <= m_data.size())
+  {
+    uint32_t type = Get<uint32_t>(offset);
+    size_t payload = offset + 8;
+    switch (type)
+    {
+      case MeasurementRecorder::SCHEMA:
+      {
+        uint16_t sourceSize = Get<uint16_t>(payload + 4);
+        uint16_t nameSize = Get<uint16_t>(payload + 6);
+        m_schema[Get<uint32_t>(payload)] = {m_data.substr(payload + 8, sourceSize),
+                                            m_data.substr(payload + 8 + sourceSize, nameSize)};
+        break;
+      }
+      case MeasurementRecorder::STEP:
+        m_steps.push_back({Get<uint64_t>(payload), Get<double>(payload + 8), payload});
+        break;
+      case MeasurementRecorder::ACTION:
+      {
+        //the first action of a measurement is the agent reply, the later ones are the steps applied until the next exchange.
+        double tsMs = Get<double>(payload + 8);
+        if (m_actions.find(tsMs) == m_actions.end())
+        {
+          uint64_t size = Get<uint64_t>(payload + 16);
+          m_actions[tsMs] = json::parse(m_data.data() + payload + 24, m_data.data() + payload + 24 + size);
+        }
+        break;
+      }
+      default:
+        NS_FATAL_ERROR("Unknown record type " << type << " in " << path);
+    }
+    offset = payload + Get<uint32_t>(offset + 4);
+  }
+  NS_LOG_INFO (path << ": " << m_steps.size() << " steps and " << m_actions.size() << " actions");
+}
+
+const std::vector<MeasurementReplay::Step>&
+MeasurementReplay::GetSteps () const
+{
+  return m_steps;
+}
+
+json
+MeasurementReplay::GetNetworkStats (const Step& step) const
+{
+  json networkStats = json::array();
+  uint32_t columns = Get<uint32_t>(step.offset + 16);
+  size_t pos = step.offset + 24;
+  for (uint32_t i = 0; i < columns; i++)
+  {
+    uint32_t schemaId = Get<uint32_t>(pos);
+    uint32_t valueType = Get<uint32_t>(pos + 4);
+    uint64_t ts = Get<uint64_t>(pos + 8);
+    uint64_t n = Get<uint64_t>(pos + 16);
+    pos += 24;
+    auto schemaIt = m_schema.find(schemaId);
+    if (schemaIt == m_schema.end())
+    {
+      NS_FATAL_ERROR("Unknown schema id " << schemaId << " in " << m_path);
+    }
+    std::vector<uint64_t> ids(n);
+    for (uint64_t k = 0; k < n; k++)
+    {
+      ids[k] = Get<uint64_t>(pos + 8 * k);
+    }
+    pos += 8 * n;
+
+    json measurement;
+    measurement["source"] = schemaIt->second.first;
+    measurement["id"] = std::move(ids);
+    measurement["ts"] = ts;
+    measurement["name"] = schemaIt->second.second;
+    if (valueType == MeasurementRecorder::DOUBLE)
+    {
+      std::vector<double> values(n);
+      for (uint64_t k = 0; k < n; k++)
+      {
+        values[k] = Get<double>(pos + 8 * k);
+      }
+      pos += 8 * n;
+      measurement["value"] = std::move(values);
+    }
+    else
+    {
+      uint64_t size = Get<uint64_t>(pos);
+      measurement["value"] = json::parse(m_data.data() + pos + 8, m_data.data() + pos + 8 + size);
+      pos += 8 + (size + 7) / 8 * 8;
+    }
+    networkStats.push_back(std::move(measurement));
+  }
+  return networkStats;
+}
+
+const json*
+MeasurementReplay::GetAction (double tsMs) const
+{
+  auto it = m_actions.find(tsMs);
+  return it == m_actions.end() ? nullptr : &it->second;
+}
+
+}
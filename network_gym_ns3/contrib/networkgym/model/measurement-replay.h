@@ -0,0 +1,52 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef MEASUREMENT_REPLAY_H
+#define MEASUREMENT_REPLAY_H
+
+#include "json.hpp"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+using json = nlohmann::json;
+namespace ns3 {
+
+/*
+Read a file written by the MeasurementRecorder. The records are indexed once when the file is opened; the network stats
+of a step are rebuilt in the json layout of the merged network stats when the step is read.
+*/
+class MeasurementReplay
+{
+public:
+  struct Step
+  {
+    uint64_t step;
+    double tsMs;
+    size_t offset; //offset of the step payload in the file.
+  };
+
+  MeasurementReplay ();
+
+  void Open (const std::string& path); //read and index the file, NS_FATAL_ERROR if it is not a measurement record.
+  const std::vector<Step>& GetSteps () const;
+  json GetNetworkStats (const Step& step) const;
+  const json* GetAction (double tsMs) const; //the first action recorded for the measurement at tsMs, nullptr if none.
+
+private:
+  template <class T>
+  T Get (size_t offset) const;
+
+  std::string m_path;
+  std::string m_data;
+  std::map<uint32_t, std::pair<std::string, std::string>> m_schema; //schema id -> source, name
+  std::vector<Step> m_steps;
+  std::map<double, json> m_actions; //measurement ts -> action list
+};
+
+}
+
+#endif /* MEASUREMENT_REPLAY_H */
@@ -0,0 +1,150 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "phase-timer.h"
+#include <algorithm>
+#include <bit>
+
+namespace ns3 {
+
+static const char* g_phaseNames[PhaseTimer::PHASE_COUNT] = {"simulate", "append", "merge", "serialize", "send", "wait", "parse", "dispatch"};
+static const char* g_counterNames[PhaseTimer::COUNTER_COUNT] = {"measurement_bytes", "action_bytes"};
+
+PhaseTimer::PhaseTimer ()
+{
+}
+
+void
+PhaseTimer::SetEnabled (bool enabled)
+{
+  m_enabled = enabled;
+}
+
+bool
+PhaseTimer::IsEnabled () const
+{
+  return m_enabled;
+}
+
+uint64_t
+PhaseTimer::NowUs ()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t
+PhaseTimer::Start () const
+{
+  return m_enabled ? NowUs() : 0;
+}
+
+void
+PhaseTimer::Stop (Phase phase, uint64_t startUs)
+{
+  if (!m_enabled || startUs == 0)
+  {
+    return;
+  }
+  Record(phase, NowUs() - startUs);
+}
+
+void
+PhaseTimer::Record (Phase phase, uint64_t us)
+{
+  Histogram& histogram = m_histograms[phase];
+  histogram.counts[GetBucket(us)]++;
+  histogram.count++;
+  histogram.totalUs += us;
+}
+
+void
+PhaseTimer::AddBytes (Counter counter, uint64_t bytes)
+{
+  if (m_enabled)
+  {
+    m_counters[counter] += bytes;
+  }
+}
+
+uint32_t
+PhaseTimer::GetBucket (uint64_t us)
+{
+  if (us < 2 * SUB_BUCKETS)
+  {
+    return us; //exact below 16 us.
+  }
+  //keep the 4 most significant bits, the first bucket of each power of two starts at 8 << shift.
+  uint32_t shift = std::bit_width(us) - 4;
+  return 2 * SUB_BUCKETS + (shift - 1) * SUB_BUCKETS + (us >> shift) - SUB_BUCKETS;
+}
+
+uint64_t
+PhaseTimer::GetBucketLowerBound (uint32_t bucket)
+{
+  if (bucket < 2 * SUB_BUCKETS)
+  {
+    return bucket;
+  }
+  uint32_t shift = (bucket - 2 * SUB_BUCKETS) / SUB_BUCKETS + 1;
+  uint64_t mantissa = (bucket - 2 * SUB_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS;
+  return mantissa << shift;
+}
+
+uint64_t
+PhaseTimer::GetCount (Phase phase) const
+{
+  return m_histograms[phase].count;
+}
+
+uint64_t
+PhaseTimer::GetPercentile (Phase phase, double p) const
+{
+  const Histogram& histogram = m_histograms[phase];
+  if (histogram.count == 0)
+  {
+    return 0;
+  }
+  //the rank of the p quantile, 1-based.
+  uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(p * histogram.count + 0.5));
+  uint64_t seen = 0;
+  for (uint32_t bucket = 0; bucket < BUCKET_COUNT; bucket++)
+  {
+    seen += histogram.counts[bucket];
+    if (seen >= rank)
+    {
+      return GetBucketLowerBound(bucket);
+    }
+  }
+  return GetBucketLowerBound(BUCKET_COUNT - 1);
+}
+
+json
+PhaseTimer::GetJson () const
+{
+  json element;
+  for (uint32_t phase = 0; phase < PHASE_COUNT; phase++)
+  {
+    const Histogram& histogram = m_histograms[phase];
+    if (histogram.count == 0)
+    {
+      continue;
+    }
+    json stats;
+    stats["count"] = histogram.count;
+    stats["total_us"] = histogram.totalUs;
+    stats["p50_us"] = GetPercentile(static_cast<Phase>(phase), 0.5);
+    stats["p99_us"] = GetPercentile(static_cast<Phase>(phase), 0.99);
+    element[g_phaseNames[phase]] = stats;
+  }
+  for (uint32_t counter = 0; counter < COUNTER_COUNT; counter++)
+  {
+    element[g_counterNames[counter]] = m_counters[counter];
+  }
+  return element;
+}
+
+}
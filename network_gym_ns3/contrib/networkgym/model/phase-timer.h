@@ -0,0 +1,78 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef PHASE_TIMER_H
+#define PHASE_TIMER_H
+
+#include "json.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+using json = nlohmann::json;
+namespace ns3 {
+
+/*
+Wall clock (steady_clock) timing of the step phases, in microseconds. Each phase keeps a log-linear histogram with 8
+sub-buckets per power of two, i.e., the percentiles are within 12.5% of the sample. The timer costs one branch per phase
+when disabled and two clock reads when enabled.
+*/
+class PhaseTimer
+{
+public:
+  enum Phase
+  {
+    SIMULATE, //from the end of a step to the next measurement exchange, including the measurement generation.
+    APPEND, //subscription filtering and batch append of the measurements.
+    MERGE, //flush of the measurement batch into the network stats.
+    SERIALIZE, //json dump or binary encoding of the measurement report.
+    SEND, //zmq send of the measurement report.
+    WAIT, //zmq poll and receive of the action, including the parse of every queued msg unless ParseLatestActionOnly is set.
+    PARSE, //parse of the action msg.
+    DISPATCH, //action dispatch to the callbacks.
+    PHASE_COUNT
+  };
+  enum Counter
+  {
+    MEASUREMENT_BYTES, //bytes of the measurement reports sent.
+    ACTION_BYTES, //bytes of the action msgs received.
+    COUNTER_COUNT
+  };
+
+  PhaseTimer ();
+
+  void SetEnabled (bool enabled);
+  bool IsEnabled () const;
+  uint64_t Start () const; //return the current time in us, 0 if disabled.
+  void Stop (Phase phase, uint64_t startUs); //record the time since startUs, skipped if disabled or startUs is 0.
+  void Record (Phase phase, uint64_t us);
+  void AddBytes (Counter counter, uint64_t bytes);
+  uint64_t GetCount (Phase phase) const;
+  uint64_t GetPercentile (Phase phase, double p) const; //lower bound of the bucket of the p quantile, 0 < p <= 1.
+  json GetJson () const; //{"<phase>": {"count", "total_us", "p50_us", "p99_us"}, ..., "<counter>": bytes}
+
+  static uint32_t GetBucket (uint64_t us);
+  static uint64_t GetBucketLowerBound (uint32_t bucket);
+
+private:
+  static constexpr uint32_t SUB_BUCKETS = 8;
+  static constexpr uint32_t BUCKET_COUNT = 2 * SUB_BUCKETS + 60 * SUB_BUCKETS; //covers every uint64_t value.
+  struct Histogram
+  {
+    std::array<uint64_t, BUCKET_COUNT> counts{};
+    uint64_t count = 0;
+    uint64_t totalUs = 0;
+  };
+
+  static uint64_t NowUs ();
+
+  bool m_enabled = false;
+  std::array<Histogram, PHASE_COUNT> m_histograms;
+  std::array<uint64_t, COUNTER_COUNT> m_counters{};
+};
+
+}
+
+#endif /* PHASE_TIMER_H */
@@ -9,6 +9,7 @@
 #include <sys/time.h>
 #include <unistd.h>
 #include <chrono>
+#include <string_view>
 using json = nlohmann::json;
 
 namespace ns3 {
@@ -29,6 +30,36 @@ SouthboundInterface::GetTypeId (void)
                 IntegerValue (600000),
                 MakeIntegerAccessor (&SouthboundInterface::m_maxActionWaitTime),
                 MakeIntegerChecker<int> ())
+    .AddAttribute ("MeasurementEncoding",
+                "Encoding of the network stats. json sends the full report as text; msgpack and cbor send a json header "
+                "plus a binary frame with [schema_id, ts, id, value] columns, the source and name of each schema id are sent once.",
+                EnumValue (SouthboundInterface::JSON),
+                MakeEnumAccessor<Encoding> (&SouthboundInterface::m_encoding),
+                MakeEnumChecker (SouthboundInterface::JSON, "json",
+                                 SouthboundInterface::MSGPACK, "msgpack",
+                                 SouthboundInterface::CBOR, "cbor"))
+    .AddAttribute ("ParseLatestActionOnly",
+                "If true, the stale action msgs queued in the socket are dropped without parsing, only the last one is parsed. "
+                "Otherwise, every queued msg is parsed and checked, and the last one is used.",
+                BooleanValue (false),
+                MakeBooleanAccessor (&SouthboundInterface::m_parseLatestActionOnly),
+                MakeBooleanChecker ())
+    .AddAttribute ("SendHighWaterMark",
+                "ZMQ_SNDHWM of the socket, the max number of queued outgoing msgs. Set before the measurement starts.",
+                IntegerValue (1000),
+                MakeIntegerAccessor (&SouthboundInterface::m_sendHighWaterMark),
+                MakeIntegerChecker<int> (0))
+    .AddAttribute ("SendBufferSize",
+                "ZMQ_SNDBUF of the socket in bytes, e.g., a few MB for large network stats, 0 keeps the OS default. "
+                "TCP_NODELAY is always set by zmq.",
+                IntegerValue (0),
+                MakeIntegerAccessor (&SouthboundInterface::m_sendBufferSize),
+                MakeIntegerChecker<int> (0))
+    .AddAttribute ("ReceiveBufferSize",
+                "ZMQ_RCVBUF of the socket in bytes, 0 keeps the OS default.",
+                IntegerValue (0),
+                MakeIntegerAccessor (&SouthboundInterface::m_receiveBufferSize),
+                MakeIntegerChecker<int> (0))
   ;
   return tid;
 }
@@ -36,7 +67,6 @@ SouthboundInterface::GetTypeId (void)
 SouthboundInterface::SouthboundInterface ()
 {
   NS_LOG_FUNCTION (this);
-  Connect();
 }
 
 SouthboundInterface::~SouthboundInterface ()
@@ -47,15 +77,40 @@ SouthboundInterface::~SouthboundInterface ()
 void
 SouthboundInterface::DoDispose (void)
 {
+  if (!IsConnected())
+  {
+    return;
+  }
   zmq_close (m_zmq_socket);
   zmq_ctx_destroy (m_zmq_context);
   std::cout  << m_workerName << ": ns3 disconnected from NetworkGym." << std::endl;
+  m_zmq_socket = nullptr;
+  m_zmq_context = nullptr;
+  //every buffer sent is released by now, the context waits for the queued msgs up to the linger time.
+  std::lock_guard<std::mutex> lock(m_bufferMutex);
+  m_freeBuffers.clear();
+}
+
+bool
+SouthboundInterface::IsConnected () const
+{
+  return m_zmq_socket != nullptr;
+}
+
+PhaseTimer&
+SouthboundInterface::GetPhaseTimer ()
+{
+  return m_phaseTimer;
 }
 
 
 void
 SouthboundInterface::Connect()
 {
+  if (IsConnected())
+  {
+    return;
+  }
   std::ifstream jsonStream("gym-configure.json");
   json jsonConfig;
   jsonStream >> jsonConfig;
@@ -66,31 +121,66 @@ SouthboundInterface::Connect()
 
   std::string plain_username = jsonConfig["session_name"].get<std::string>();
   std::string plain_password = jsonConfig["session_key"].get<std::string>();
-  int portN = jsonConfig["env_port"].get<int>();
+  std::string endpoint = GetEndpoint(jsonConfig);
   std::cout << m_workerName << ": ns3 connecting to NetworkGym." << std::endl;
   m_zmq_context = zmq_ctx_new ();
   m_zmq_socket = zmq_socket (m_zmq_context, ZMQ_DEALER);
   zmq_setsockopt (m_zmq_socket, ZMQ_PLAIN_USERNAME, plain_username.c_str(), plain_username.size());
   zmq_setsockopt (m_zmq_socket, ZMQ_PLAIN_PASSWORD, plain_password.c_str(), plain_password.size());
   zmq_setsockopt (m_zmq_socket, ZMQ_IDENTITY, m_workerName.c_str(), m_workerName.size());
-  int64_t linger = 10000;
+  int linger = 10000;
   zmq_setsockopt (m_zmq_socket, ZMQ_LINGER, &linger, sizeof linger);
-  std::string addrAndPort = "tcp://localhost:"+std::to_string(portN);
-  zmq_connect (m_zmq_socket, addrAndPort.c_str());
+  zmq_setsockopt (m_zmq_socket, ZMQ_SNDHWM, &m_sendHighWaterMark, sizeof m_sendHighWaterMark);
+  if (m_sendBufferSize > 0)
+  {
+    zmq_setsockopt (m_zmq_socket, ZMQ_SNDBUF, &m_sendBufferSize, sizeof m_sendBufferSize);
+  }
+  if (m_receiveBufferSize > 0)
+  {
+    zmq_setsockopt (m_zmq_socket, ZMQ_RCVBUF, &m_receiveBufferSize, sizeof m_receiveBufferSize);
+  }
+  NS_LOG_INFO (m_workerName << ": endpoint " << endpoint);
+  zmq_connect (m_zmq_socket, endpoint.c_str());
 
 }
 
+std::string
+SouthboundInterface::GetEndpoint (const json& jsonConfig)
+{
+  int portN = jsonConfig["env_port"].get<int>();
+  std::string transport = jsonConfig.value("env_transport", "tcp");
+  if (transport == "tcp")
+  {
+    return "tcp://localhost:"+std::to_string(portN);
+  }
+  else if (transport == "ipc")
+  {
+    //the server binds the same path, see network_gym_sim_ipc_path in the server config.
+    return "ipc://" + jsonConfig.value("env_ipc_path", "/tmp/network_gym_sim_"+std::to_string(portN));
+  }
+  NS_FATAL_ERROR ("Unknown env_transport " << transport << " in gym-configure.json, use tcp or ipc.");
+  return "";
+}
+
 void
 SouthboundInterface::SendMeasurementJson(json& networkStats, json& workloadStats)
 {
   json measurementReport = {};
   measurementReport["type"] = "env-measurement";
 
-  measurementReport["network_stats"] = networkStats;
-  measurementReport["workload_stats"] = workloadStats;
-  std::string j_str =measurementReport.dump();
-  zmq_send (m_zmq_socket, m_clientIdentity.c_str(), m_clientIdentity.size(), ZMQ_SNDMORE);
-  zmq_send (m_zmq_socket, j_str.c_str(), j_str.size(), 0);
+  measurementReport["workload_stats"] = std::move(workloadStats);
+  SendMeasurement(measurementReport, networkStats);
+}
+
+void
+SouthboundInterface::SendMeasurementJson(json& networkStats, json& workloadStats, const std::string& agent)
+{
+  json measurementReport = {};
+  measurementReport["type"] = "env-measurement";
+  measurementReport["agent"] = agent; //the client replies with the same agent name in the action.
+
+  measurementReport["workload_stats"] = std::move(workloadStats);
+  SendMeasurement(measurementReport, networkStats);
 }
 
 void
@@ -99,16 +189,138 @@ SouthboundInterface::SendMeasurementJson(json& networkStats)
   json measurementReport = {};
   measurementReport["type"] = "env-measurement";
 
-  measurementReport["network_stats"] = networkStats;
-  std::string j_str =measurementReport.dump();
-  zmq_send (m_zmq_socket, m_clientIdentity.c_str(), m_clientIdentity.size(), ZMQ_SNDMORE);
-  zmq_send (m_zmq_socket, j_str.c_str(), j_str.size(), 0);
+  SendMeasurement(measurementReport, networkStats);
+}
+
+void
+SouthboundInterface::SendMeasurement (json& measurementReport, json& networkStats)
+{
+  if (m_encoding != JSON)
+  {
+    SendMeasurementBinary(measurementReport, networkStats);
+    return;
+  }
+  uint64_t serializeStartUs = m_phaseTimer.Start();
+  //the network stats are moved into the report instead of being copied.
+  measurementReport["network_stats"] = std::move(networkStats);
+  SendBuffer* buffer = AcquireBuffer();
+  buffer->data = measurementReport.dump();
+  m_phaseTimer.Stop(PhaseTimer::SERIALIZE, serializeStartUs);
+  SendFrames(buffer, nullptr);
+}
+
+void
+SouthboundInterface::SendFrames (SendBuffer* header, SendBuffer* payload)
+{
+  uint64_t sendStartUs = m_phaseTimer.Start();
+  size_t bytes = header->data.size() + (payload ? payload->data.size() : 0);
+  //the identity is constant while connected, zmq references it without a copy.
+  zmq_send_const (m_zmq_socket, m_clientIdentity.data(), m_clientIdentity.size(), ZMQ_SNDMORE);
+  SendBufferFrame (header, payload ? ZMQ_SNDMORE : 0);
+  if (payload)
+  {
+    SendBufferFrame (payload, 0);
+  }
+  m_phaseTimer.Stop(PhaseTimer::SEND, sendStartUs);
+  m_phaseTimer.AddBytes(PhaseTimer::MEASUREMENT_BYTES, bytes);
+}
+
+SouthboundInterface::SendBuffer*
+SouthboundInterface::AcquireBuffer ()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_bufferMutex);
+    if (!m_freeBuffers.empty())
+    {
+      SendBuffer* buffer = m_freeBuffers.back().release();
+      m_freeBuffers.pop_back();
+      return buffer;
+    }
+  }
+  return new SendBuffer{std::string(), this};
+}
+
+void
+SouthboundInterface::SendBufferFrame (SendBuffer* buffer, int flags)
+{
+  zmq_msg_t msg;
+  zmq_msg_init_data (&msg, buffer->data.data(), buffer->data.size(), &SouthboundInterface::ReleaseBuffer, buffer);
+  if (zmq_msg_send (&msg, m_zmq_socket, flags) == -1)
+  {
+    zmq_msg_close (&msg); //releases the buffer.
+    NS_FATAL_ERROR("Send ERROR: " << zmq_strerror(zmq_errno()));
+  }
+}
+
+void
+SouthboundInterface::ReleaseBuffer (void* data, void* hint)
+{
+  std::unique_ptr<SendBuffer> buffer (static_cast<SendBuffer*>(hint));
+  SouthboundInterface* owner = buffer->owner;
+  buffer->data.clear(); //keeps the capacity for the next measurement.
+  std::lock_guard<std::mutex> lock(owner->m_bufferMutex);
+  if (owner->m_freeBuffers.size() < MAX_FREE_BUFFERS)
+  {
+    owner->m_freeBuffers.push_back(std::move(buffer));
+  }
+}
+
+bool
+SouthboundInterface::IsBinaryEncoding () const
+{
+  return m_encoding != JSON;
+}
+
+void
+SouthboundInterface::SendMeasurementColumns (MeasurementAggregator& batch, json& workloadStats)
+{
+  if (m_encoding == JSON)
+  {
+    NS_FATAL_ERROR("The merged columns are only sent in the msgpack or cbor encoding.");
+  }
+  json measurementReport = {};
+  measurementReport["type"] = "env-measurement";
+  measurementReport["workload_stats"] = std::move(workloadStats);
+
+  uint64_t serializeStartUs = m_phaseTimer.Start();
+  json schema = json::array();
+  SendBuffer* payload = AcquireBuffer();
+  m_encoder.SetCbor(m_encoding == CBOR);
+  m_encoder.Encode(batch, schema, payload->data);
+  SendBinaryFrames(measurementReport, schema, payload);
+  m_phaseTimer.Stop(PhaseTimer::SERIALIZE, serializeStartUs);
+}
+
+void
+SouthboundInterface::SendMeasurementBinary (json& measurementReport, const json& networkStats)
+{
+  uint64_t serializeStartUs = m_phaseTimer.Start();
+  json schema = json::array();
+  SendBuffer* payload = AcquireBuffer();
+  m_encoder.SetCbor(m_encoding == CBOR);
+  m_encoder.Encode(networkStats, schema, payload->data);
+  SendBinaryFrames(measurementReport, schema, payload);
+  m_phaseTimer.Stop(PhaseTimer::SERIALIZE, serializeStartUs);
+}
+
+void
+SouthboundInterface::SendBinaryFrames (json& measurementReport, json& schema, SendBuffer* payload)
+{
+  measurementReport["encoding"] = m_encoding == MSGPACK ? "msgpack" : "cbor";
+  if (!schema.empty())
+  {
+    measurementReport["schema"] = std::move(schema);
+  }
+  SendBuffer* header = AcquireBuffer();
+  header->data = measurementReport.dump();
+  SendFrames(header, payload);
 }
 
 void
-SouthboundInterface::GetAction(json& action, bool raiseError)
+SouthboundInterface::GetAction(json& action, bool raiseError, bool drain)
 {
 
+  uint64_t waitStartUs = m_phaseTimer.Start();
   /* Poll for events for m_maxActionWaitTime */
   zmq_pollitem_t items [] = {
       { m_zmq_socket,   0, ZMQ_POLLIN, 0 },
@@ -123,43 +335,23 @@ SouthboundInterface::GetAction(json& action, bool raiseError)
   }
 
   assert (rc >= 0); /* Returned events will be stored in items[].revents */
-  json j_msg;
+  zmq_msg_t msg;
+  zmq_msg_init (&msg);
+  bool received = false;
   while(rc > 0)//while there is a msg in the socket, we get the last one!
   {
-    //the server sends two msgs: (1) algorithm client indentiy and followed by the (2) msg.
-
-    //(1) RX identity
-    char identity [1024];
-    int size = zmq_recv (m_zmq_socket, identity, 1023, 0);
-    if (size == -1 || size > 1023)
-    {
-      NS_FATAL_ERROR("Receive ERROR");
-    }
-    identity [size] = '\0';
-    if (m_clientIdentity != identity)
+    ReceiveActionMsg(msg);
+    received = true;
+    if (!m_parseLatestActionOnly)
     {
-      NS_FATAL_ERROR("client identity changed! from " << m_clientIdentity << " to " << identity);
+      ParseAction(msg, action);
     }
-    //std::cout << "Received Identity: "<< m_clientIdentity << std::endl;
-
-    //(2) RX action msg
-    char buffer [10001];
-    size = zmq_recv (m_zmq_socket, buffer, 10000, 0);
-    if (size == -1 || size > 10000)
-    {
-      NS_FATAL_ERROR("Receive ERROR");
-    }
-    buffer [size] = '\0';
-    //std::cout << "Received: "<< buffer << std::endl;
-
-    action = json::parse(buffer);
-    if(action["type"].get<std::string>().compare("env-action") != 0 )
+    if (!drain)
     {
-      NS_FATAL_ERROR("Unkown MSG, the client should only receive env-action, but received :" << action["type"].get<std::string>());
+      //the later msgs are the actions of the following measurements, keep them in the socket.
+      break;
     }
 
-    //this is the action we are expecting...
-    std::cout << Now().GetSeconds() << " NetworkGym Southbound RX [env-action]" << std::endl;
     zmq_pollitem_t items [] = {
           { m_zmq_socket,   0, ZMQ_POLLIN, 0 },
       };
@@ -167,6 +359,78 @@ SouthboundInterface::GetAction(json& action, bool raiseError)
     assert (rc >= 0); /* Returned events will be stored in items[].revents */
   }
 
+  m_phaseTimer.Stop(PhaseTimer::WAIT, waitStartUs);
+
+  if (received && m_parseLatestActionOnly)
+  {
+    ParseAction(msg, action);
+  }
+  zmq_msg_close (&msg);
+}
+
+bool
+SouthboundInterface::PollAction (json& action)
+{
+  zmq_pollitem_t items [] = {
+      { m_zmq_socket,   0, ZMQ_POLLIN, 0 },
+  };
+  int rc = zmq_poll (items, 1, 0);
+  assert (rc >= 0);
+  if (rc == 0)
+  {
+    return false;
+  }
+  zmq_msg_t msg;
+  zmq_msg_init (&msg);
+  ReceiveActionMsg(msg);
+  ParseAction(msg, action);
+  zmq_msg_close (&msg);
+  return true;
+}
+
+void
+SouthboundInterface::ReceiveActionMsg (zmq_msg_t& msg)
+{
+  //the server sends two msgs: (1) algorithm client indentiy and followed by the (2) msg.
+
+  //(1) RX identity
+  zmq_msg_t identity;
+  zmq_msg_init (&identity);
+  if (zmq_msg_recv (&identity, m_zmq_socket, 0) == -1)
+  {
+    NS_FATAL_ERROR("Receive ERROR");
+  }
+  std::string_view identityView (static_cast<const char*>(zmq_msg_data (&identity)), zmq_msg_size (&identity));
+  if (m_clientIdentity != identityView)
+  {
+    NS_FATAL_ERROR("client identity changed! from " << m_clientIdentity << " to " << identityView);
+  }
+  zmq_msg_close (&identity);
+  //std::cout << "Received Identity: "<< m_clientIdentity << std::endl;
+
+  //(2) RX action msg, zmq_msg_recv releases the previous (stale) msg. There is no size limit.
+  if (zmq_msg_recv (&msg, m_zmq_socket, 0) == -1)
+  {
+    NS_FATAL_ERROR("Receive ERROR");
+  }
+}
+
+void
+SouthboundInterface::ParseAction (zmq_msg_t& msg, json& action)
+{
+  uint64_t parseStartUs = m_phaseTimer.Start();
+  const char* data = static_cast<const char*>(zmq_msg_data (&msg));
+  action = json::parse(data, data + zmq_msg_size (&msg));
+  m_phaseTimer.Stop(PhaseTimer::PARSE, parseStartUs);
+  m_phaseTimer.AddBytes(PhaseTimer::ACTION_BYTES, zmq_msg_size (&msg));
+  //std::cout << "Received: "<< action << std::endl;
+  if(action["type"].get<std::string>().compare("env-action") != 0 )
+  {
+    NS_FATAL_ERROR("Unkown MSG, the client should only receive env-action, but received :" << action["type"].get<std::string>());
+  }
+
+  //this is the action we are expecting...
+  NS_LOG_INFO (Now().GetSeconds() << " NetworkGym Southbound RX [env-action]");
 }
 
 
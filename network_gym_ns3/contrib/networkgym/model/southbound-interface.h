@@ -10,6 +10,13 @@
 #include <zmq.hpp>
 #include "ns3/core-module.h"
 #include "json.hpp"
+#include "ns3/phase-timer.h"
+#include "ns3/measurement-aggregator.h"
+#include "ns3/measurement-encoder.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 using json = nlohmann::json;
 namespace ns3 {
@@ -25,16 +32,59 @@ public:
   virtual void DoDispose (void);
 
   static TypeId GetTypeId (void);
+  enum Encoding
+  {
+    JSON,
+    MSGPACK,
+    CBOR
+  };
+  //the stats are moved into the measurement report, they are empty after the send.
   void SendMeasurementJson (json& networkStats, json& workloadStats); //network stats and workload stats measurement
   void SendMeasurementJson (json& networkStats); //network stats measurement
-  void GetAction (json& action, bool raiseError); //if raiseError = true, the program exits with error when the action is not received after poll timeout.
+  void SendMeasurementJson (json& networkStats, json& workloadStats, const std::string& agent); //multi-agent mode, the measurement is tagged with the agent name.
+  void SendMeasurementColumns (MeasurementAggregator& batch, json& workloadStats); //binary encoding only, the merged columns of the batch are encoded without building the network stats json.
+  bool IsBinaryEncoding () const;
+  void GetAction (json& action, bool raiseError, bool drain = true); //if raiseError = true, the program exits with error when the action is not received after poll timeout. if drain = false, only the next queued action is received.
+  bool PollAction (json& action); //receive the next queued action without waiting, return false if no action is queued.
+  void Connect(); //open the zmq context and socket, called when the measurement starts. No zmq state exists before, so the process can be forked until then.
+  bool IsConnected () const;
+  PhaseTimer& GetPhaseTimer (); //the serialize, send, wait and parse phases are timed here, the others by the data processor.
 
 private:
-  void Connect();
+  static std::string GetEndpoint (const json& jsonConfig); //tcp://localhost:env_port, or ipc://env_ipc_path if env_transport is ipc.
+  /*
+  The frames are serialized into reusable buffers and handed to zmq without a copy. zmq owns a buffer until it is sent
+  and returns it from an I/O thread through ReleaseBuffer, so the free list is guarded by a mutex.
+  */
+  struct SendBuffer
+  {
+    std::string data;
+    SouthboundInterface* owner;
+  };
+  static constexpr size_t MAX_FREE_BUFFERS = 4; //buffers kept for reuse, with their capacity.
+
+  void SendMeasurement (json& measurementReport, json& networkStats); //encode and send the report with the network stats, moved into the json report.
+  void SendFrames (SendBuffer* header, SendBuffer* payload); //the payload frame is skipped if null.
+  void SendMeasurementBinary (json& measurementReport, const json& networkStats); //send the report header as json and the network stats as a binary frame.
+  void SendBinaryFrames (json& measurementReport, json& schema, SendBuffer* payload); //add the new schema entries to the header and send it with the payload.
+  SendBuffer* AcquireBuffer (); //an empty buffer from the free list, or a new one.
+  void SendBufferFrame (SendBuffer* buffer, int flags); //zero-copy send, the buffer returns to the free list once sent.
+  static void ReleaseBuffer (void* data, void* hint); //zmq free callback, hint is the SendBuffer.
+  void ReceiveActionMsg (zmq_msg_t& msg); //receive the client identity and the action msg, check the identity.
+  void ParseAction (zmq_msg_t& msg, json& action); //parse the action from the msg data in place.
   int m_maxActionWaitTime; //unit ms
+  bool m_parseLatestActionOnly; //if true, only the last queued action msg is parsed.
+  Encoding m_encoding; //encoding of the network stats.
+  MeasurementEncoder m_encoder; //binary frame of the network stats, each schema id is announced to the client once.
+  PhaseTimer m_phaseTimer;
+  int m_sendHighWaterMark; //ZMQ_SNDHWM
+  int m_sendBufferSize; //ZMQ_SNDBUF, 0 keeps the OS default.
+  int m_receiveBufferSize; //ZMQ_RCVBUF, 0 keeps the OS default.
+  std::mutex m_bufferMutex; //guards m_freeBuffers.
+  std::vector<std::unique_ptr<SendBuffer>> m_freeBuffers; //destroyed after the zmq context, which releases the buffers in flight.
 
-  void *m_zmq_context;
-  void *m_zmq_socket;
+  void *m_zmq_context = nullptr;
+  void *m_zmq_socket = nullptr;
   std::string m_workerName;
   std::string m_clientIdentity;
 
@@ -0,0 +1,128 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#include "tgax-residential-propagation-loss-model.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/mobility-building-info.h"
+
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TgaxResidentialPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED(TgaxResidentialPropagationLossModel);
+
+TypeId
+TgaxResidentialPropagationLossModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TgaxResidentialPropagationLossModel")
+            .SetParent<PropagationLossModel>()
+            .SetGroupName("Wifi")
+            .AddConstructor<TgaxResidentialPropagationLossModel>()
+            .AddAttribute("Frequency",
+                          "The carrier frequency (in Hz) at which propagation occurs",
+                          DoubleValue(2.437e9),
+                          MakeDoubleAccessor(&TgaxResidentialPropagationLossModel::m_frequencyHz),
+                          MakeDoubleChecker<double>())
+            .AddAttribute(
+                "ShadowSigma",
+                "Standard deviation (dB) of the normal distribution used to calculate shadowing "
+                "loss",
+                DoubleValue(5.0),
+                MakeDoubleAccessor(&TgaxResidentialPropagationLossModel::m_shadowingSigma),
+                MakeDoubleChecker<double>());
+    return tid;
+}
+
+TgaxResidentialPropagationLossModel::TgaxResidentialPropagationLossModel()
+{
+    m_shadowingRandomVariable = CreateObject<NormalRandomVariable>();
+}
+
+TgaxResidentialPropagationLossModel::Location
+TgaxResidentialPropagationLossModel::GetLocation(Ptr<MobilityModel> model)
+{
+    Location location;
+    location.position = model->GetPosition();
+    Ptr<MobilityBuildingInfo> info = model->GetObject<MobilityBuildingInfo>();
+    location.hasBuildingInfo = info != nullptr;
+    location.indoor = info && info->IsIndoor();
+    location.floor = info ? info->GetFloorNumber() : 0;
+    location.roomX = info ? info->GetRoomNumberX() : 0;
+    location.roomY = info ? info->GetRoomNumberY() : 0;
+    return location;
+}
+
+double
+TgaxResidentialPropagationLossModel::DoCalcRxPower(double txPowerDbm,
+                                                   Ptr<MobilityModel> a,
+                                                   Ptr<MobilityModel> b) const
+{
+    return CalcLocationRxPower(txPowerDbm, GetLocation(a), GetLocation(b));
+}
+
+double
+TgaxResidentialPropagationLossModel::CalcLocationRxPower(double txPowerDbm,
+                                                         const Location& a,
+                                                         const Location& b) const
+{
+    double distance = CalculateDistance(a.position, b.position);
+
+    if (distance == 0)
+    {
+        return txPowerDbm;
+    }
+
+    distance = std::max(1.0, distance); // 1m minimum distance
+    double pathlossDb;
+    double breakpointDistance = 5; // meters
+    double fc = 2.4e9;             // carrier frequency, Hz
+    uint16_t floors = 0;
+    uint16_t walls = 0;
+    if (a.hasBuildingInfo && b.hasBuildingInfo)
+    {
+        if (!a.indoor || !b.indoor)
+        {
+            NS_LOG_DEBUG("One or both nodes is outdoor, so returning zero signal power");
+            return 0;
+        }
+        floors = std::abs(a.floor - b.floor);
+        walls = std::abs(a.roomX - b.roomX) + std::abs(a.roomY - b.roomY);
+    }
+
+    pathlossDb = 40.05 + 20 * std::log10(m_frequencyHz / fc) +
+                 20 * std::log10(std::min(distance, breakpointDistance));
+    if (distance > breakpointDistance)
+    {
+        pathlossDb += 35 * std::log10(distance / 5);
+    }
+    if (floors)
+    {
+        pathlossDb +=
+            18.3 * std::pow((distance / floors),
+                            ((distance / floors) + 2.0) / ((distance / floors) + 1.0) - 0.46);
+    }
+    if (walls)
+    {
+        pathlossDb += 5.0 * (walls); // Changed (distance/walls) to only (walls) because the
+                                     // pathloss would isolate the rooms
+    }
+
+    return txPowerDbm - pathlossDb;
+}
+
+int64_t
+TgaxResidentialPropagationLossModel::DoAssignStreams(int64_t stream)
+{
+    m_shadowingRandomVariable->SetStream(stream);
+    return 1;
+}
+
+} // namespace ns3
@@ -0,0 +1,78 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+#ifndef TGAX_RESIDENTIAL_PROPAGATION_LOSS_MODEL_H
+#define TGAX_RESIDENTIAL_PROPAGATION_LOSS_MODEL_H
+
+#include "ns3/propagation-loss-model.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/vector.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup networkgym
+ *
+ * The TgaxResidentialPropagationLossModel in ns3-ai repo. The walls and floors between the
+ * nodes are taken from their MobilityBuildingInfo, if both nodes have one.
+ *
+ * The model is deterministic. CalcLocationRxPower evaluates it on a Location, which holds
+ * everything it reads from the nodes, so it can run outside of the simulator thread.
+ */
+class TgaxResidentialPropagationLossModel : public PropagationLossModel
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TgaxResidentialPropagationLossModel();
+
+    /// The position and the building info of a node
+    struct Location
+    {
+        Vector position;      //!< position
+        bool hasBuildingInfo; //!< whether the node has a MobilityBuildingInfo
+        bool indoor;          //!< the node is indoor, if it has building info
+        int floor;            //!< floor number, if it has building info
+        int roomX;            //!< room number along x, if it has building info
+        int roomY;            //!< room number along y, if it has building info
+    };
+
+    /**
+     * Read the location of a node, on the simulator thread.
+     * \param model the mobility model of the node
+     * \return the location
+     */
+    static Location GetLocation(Ptr<MobilityModel> model);
+
+    /**
+     * The RX power of DoCalcRxPower, from locations. Only plain data is read, so the call can
+     * run concurrently with other calls.
+     *
+     * \param txPowerDbm the TX power (dBm)
+     * \param a the location of the TX node
+     * \param b the location of the RX node
+     * \return the RX power (dBm)
+     */
+    double CalcLocationRxPower(double txPowerDbm, const Location& a, const Location& b) const;
+
+  protected:
+    double DoCalcRxPower(double txPowerDbm,
+                         Ptr<MobilityModel> a,
+                         Ptr<MobilityModel> b) const override;
+    int64_t DoAssignStreams(int64_t stream) override;
+
+  private:
+    double m_frequencyHz;    //!< frequency, in Hz
+    double m_shadowingSigma; //!< sigma (dB) for shadowing std. deviation
+    Ptr<NormalRandomVariable> m_shadowingRandomVariable; //!< random variable used for shadowing loss
+};
+
+} // namespace ns3
+
+#endif /* TGAX_RESIDENTIAL_PROPAGATION_LOSS_MODEL_H */
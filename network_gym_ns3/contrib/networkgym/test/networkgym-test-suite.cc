@@ -7,8 +7,34 @@
 
 // Include a header file from your module to test.
 // An essential include is test.h
+#include "ns3/action-dispatcher.h"
+#include "ns3/data-processor.h"
+#include "ns3/in-process-policy.h"
+#include "ns3/measurement-aggregator.h"
+#include "ns3/measurement-delta.h"
+#include "ns3/measurement-encoder.h"
+#include "ns3/measurement-recorder.h"
+#include "ns3/measurement-replay.h"
+#include "ns3/mobility-model.h"
+#include "ns3/networkgym-node-config.h"
+#include "ns3/networkgym-wifi-scenario.h"
+#include "ns3/networkgym-worker-pool.h"
+#include "ns3/phase-timer.h"
+#include "ns3/simulator.h"
+#include "ns3/southbound-interface.h"
+#include "ns3/tgax-residential-propagation-loss-model.h"
 #include "ns3/test.h"
 
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include <zmq.h>
+
 // Do not put your test classes in namespace ns3.  You may find it useful
 // to use the using directive to access the ns3 namespace directly
 using namespace ns3;
@@ -61,6 +87,1405 @@ NetworkgymTestCase1::DoRun()
     NS_TEST_ASSERT_MSG_EQ_TOL(0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+/**
+ * \ingroup networkgym-tests
+ * Test the merge of per-id measurements into one sorted entry per source::name
+ */
+class MeasurementAggregatorTestCase : public TestCase
+{
+  public:
+    MeasurementAggregatorTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+MeasurementAggregatorTestCase::MeasurementAggregatorTestCase()
+    : TestCase("Measurement aggregator merges and sorts by id")
+{
+}
+
+void
+MeasurementAggregatorTestCase::DoRun()
+{
+    MeasurementAggregator aggregator;
+    NS_TEST_ASSERT_MSG_EQ(aggregator.IsEmpty(), true, "new aggregator should be empty");
+
+    // Same layout as NetworkStats::Append, one id per entry, appended out of order
+    for (uint64_t id : {3, 1, 2})
+    {
+        json x;
+        x["source"] = "Obss";
+        x["id"].push_back(id);
+        x["ts"] = 1000;
+        x["name"] = "Cpp2Py::NodeX";
+        x["value"].push_back(id * 0.5);
+        aggregator.Append(x);
+
+        json mcs;
+        mcs["source"] = "Obss";
+        mcs["id"].push_back(id);
+        mcs["ts"] = 1000;
+        mcs["name"] = "Cpp2Py::McsIndex";
+        mcs["value"].push_back(static_cast<int>(id) + 4);
+        aggregator.Append(mcs);
+    }
+
+    json networkStats = aggregator.Flush();
+    std::string expected = "[{\"id\":[1,2,3],\"name\":\"Cpp2Py::NodeX\",\"source\":\"Obss\",\"ts\":1000,"
+                           "\"value\":[0.5,1.0,1.5]},"
+                           "{\"id\":[1,2,3],\"name\":\"Cpp2Py::McsIndex\",\"source\":\"Obss\",\"ts\":1000,"
+                           "\"value\":[5,6,7]}]";
+    NS_TEST_ASSERT_MSG_EQ(networkStats.dump(), expected, "unexpected merged network stats");
+    NS_TEST_ASSERT_MSG_EQ(aggregator.IsEmpty(), true, "Flush should clear the batch");
+    NS_TEST_ASSERT_MSG_EQ(aggregator.GetNKeys(), 2, "interned keys are kept across steps");
+    NS_TEST_ASSERT_MSG_EQ(aggregator.Intern("Obss", "Cpp2Py::McsIndex"), 1, "interned key changed");
+    NS_TEST_ASSERT_MSG_EQ(aggregator.Find("Obss", "Cpp2Py::NodeY"),
+                          MeasurementAggregator::INVALID_KEY,
+                          "Find should not intern new keys");
+
+    // The vectors of the only values of a key are swapped in, the ones of a second append are merged
+    uint32_t key = aggregator.Intern("Obss", "Cpp2Py::NodeX");
+    std::vector<uint64_t> ids{2, 4};
+    std::vector<double> values{2.5, 4.5};
+    const uint64_t* idData = ids.data();
+    aggregator.Append(key, 2000, std::move(ids), std::move(values));
+    NS_TEST_ASSERT_MSG_EQ(aggregator.GetColumn(key).ids.data(), idData, "the ids were copied");
+    NS_TEST_ASSERT_MSG_EQ(ids.empty(), true, "the caller should get the cleared ids of the column");
+    NS_TEST_ASSERT_MSG_EQ(values.empty(), true, "the caller should get the cleared values of the column");
+    std::vector<uint64_t> moreIds{3};
+    std::vector<double> moreValues{3.5};
+    aggregator.Append(key, 2000, std::move(moreIds), std::move(moreValues));
+    expected = "[{\"id\":[2,3,4],\"name\":\"Cpp2Py::NodeX\",\"source\":\"Obss\",\"ts\":2000,"
+               "\"value\":[2.5,3.5,4.5]}]";
+    NS_TEST_ASSERT_MSG_EQ(aggregator.Flush().dump(), expected, "unexpected network stats of the moved columns");
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Test the typed columns of NetworkStats and their reuse across steps
+ */
+class NetworkStatsTestCase : public TestCase
+{
+  public:
+    NetworkStatsTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+NetworkStatsTestCase::NetworkStatsTestCase()
+    : TestCase("NetworkStats builds one entry per metric and is reusable")
+{
+}
+
+void
+NetworkStatsTestCase::DoRun()
+{
+    Ptr<NetworkStats> meas = CreateObject<NetworkStats>("Obss");
+    meas->Reset(1000);
+    std::vector<uint64_t> ids = {0};
+    std::vector<double> values = {1.5};
+    meas->Append("Cpp2Py::NodeX", ids, values);
+    values = {2.5};
+    meas->Append("Cpp2Py::NodeY", ids, values);
+    // Repeated appends with the same name are merged into one entry
+    ids = {1};
+    values = {3.5};
+    meas->Append("Cpp2Py::NodeX", ids, values);
+    std::string expected = "[{\"id\":[0,1],\"name\":\"Cpp2Py::NodeX\",\"source\":\"Obss\",\"ts\":1000,"
+                           "\"value\":[1.5,3.5]},"
+                           "{\"id\":[0],\"name\":\"Cpp2Py::NodeY\",\"source\":\"Obss\",\"ts\":1000,"
+                           "\"value\":[2.5]}]";
+    NS_TEST_ASSERT_MSG_EQ(meas->GetJson().dump(), expected, "unexpected network stats");
+
+    // Metrics without values after Reset are skipped
+    meas->Reset(2000);
+    ids = {1, 2};
+    values = {0.25, 0.75};
+    meas->Append("Cpp2Py::NodeY", ids, values);
+    expected = "[{\"id\":[1,2],\"name\":\"Cpp2Py::NodeY\",\"source\":\"Obss\",\"ts\":2000,"
+               "\"value\":[0.25,0.75]}]";
+    NS_TEST_ASSERT_MSG_EQ(meas->GetJson().dump(), expected, "unexpected network stats after Reset");
+
+    // The name based interface keeps working
+    Ptr<NetworkStats> legacy = CreateObject<NetworkStats>("Obss", 7, 3000);
+    legacy->Append("Cpp2Py::McsIndex", 5.0);
+    json mcs = 6;
+    legacy->Append("Cpp2Py::McsIndex", mcs);
+    expected = "[{\"id\":[7,7],\"name\":\"Cpp2Py::McsIndex\",\"source\":\"Obss\",\"ts\":3000,"
+               "\"value\":[5.0,6]}]";
+    NS_TEST_ASSERT_MSG_EQ(legacy->GetJson().dump(), expected, "unexpected legacy network stats");
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Test the dispatch of an action list to the callbacks of each (source::name, id)
+ */
+class ActionDispatcherTestCase : public TestCase
+{
+  public:
+    ActionDispatcherTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+/// Values received by each id in ActionDispatcherTestCase
+static std::map<uint64_t, double> g_receivedActions;
+
+/**
+ * Store the received action value of an id
+ * \param id the id bound to the callback
+ * \param value the action value
+ */
+static void
+RecvTestAction(uint64_t id, const json& value)
+{
+    g_receivedActions[id] = value.get<double>();
+}
+
+/// Number of bulk calls and the id and value lists of the last one in ActionDispatcherTestCase
+static uint32_t g_bulkCalls = 0;
+static json g_bulkIds;    //!< ids of the last bulk call
+static json g_bulkValues; //!< values of the last bulk call
+
+/**
+ * Store the id and value lists of a bulk action
+ * \param ids the ids
+ * \param values one value per id
+ */
+static void
+RecvTestBulkAction(const json& ids, const json& values)
+{
+    g_bulkCalls++;
+    g_bulkIds = ids;
+    g_bulkValues = values;
+}
+
+ActionDispatcherTestCase::ActionDispatcherTestCase()
+    : TestCase("Action dispatcher sends each value to the callback of its id")
+{
+}
+
+void
+ActionDispatcherTestCase::DoRun()
+{
+    ActionDispatcher dispatcher;
+    for (uint64_t id : {0, 1, 5000})
+    {
+        dispatcher.Add("Obss::Py2Cpp::TxPowerNew",
+                       id,
+                       MakeBoundCallback(&RecvTestAction, id));
+    }
+    NS_TEST_ASSERT_MSG_EQ(dispatcher.GetNCallbacks(), 3, "unexpected number of callbacks");
+
+    json actionList = json::parse(R"([{"source":"Obss","name":"Py2Cpp::TxPowerNew","ts":100,)"
+                                  R"("id":[5000,0],"value":[15.0,20.0]}])");
+    dispatcher.Dispatch(actionList, 100);
+    NS_TEST_ASSERT_MSG_EQ(g_receivedActions.size(), 2, "unexpected number of actions");
+    NS_TEST_ASSERT_MSG_EQ(g_receivedActions[0], 20.0, "wrong value for id 0");
+    NS_TEST_ASSERT_MSG_EQ(g_receivedActions[5000], 15.0, "wrong value for id 5000");
+
+    // A single action entry with a scalar id
+    json action = json::parse(R"({"source":"Obss","name":"Py2Cpp::TxPowerNew","ts":200,"id":1,"value":10.0})");
+    dispatcher.Dispatch(action, 200);
+    NS_TEST_ASSERT_MSG_EQ(g_receivedActions[1], 10.0, "wrong value for id 1");
+
+    // A bulk callback receives every id of the entry in one call
+    dispatcher.AddBulk("Obss::Py2Cpp::ObssPdNew", MakeCallback(&RecvTestBulkAction));
+    actionList = json::parse(R"([{"source":"Obss","name":"Py2Cpp::ObssPdNew","ts":300,)"
+                             R"("id":[2,0,7],"value":[-70.0,-72.0,-74.0]}])");
+    dispatcher.Dispatch(actionList, 300);
+    NS_TEST_ASSERT_MSG_EQ(g_bulkCalls, 1, "the bulk callback is not called once");
+    NS_TEST_ASSERT_MSG_EQ((g_bulkIds == json::array({2, 0, 7})), true, "wrong bulk ids");
+    NS_TEST_ASSERT_MSG_EQ((g_bulkValues == json::array({-70.0, -72.0, -74.0})), true, "wrong bulk values");
+    action = json::parse(R"({"source":"Obss","name":"Py2Cpp::ObssPdNew","ts":400,"id":0,"value":-80.0})");
+    dispatcher.Dispatch(action, 400);
+    NS_TEST_ASSERT_MSG_EQ((g_bulkIds == json::array({0})), true, "a scalar id is not passed as a list");
+    NS_TEST_ASSERT_MSG_EQ(g_receivedActions.size(), 3, "the bulk action reached a per id callback");
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Test the split of the lines of the scenario configuration file
+ */
+class CsvSplitTestCase : public TestCase
+{
+  public:
+    CsvSplitTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+CsvSplitTestCase::CsvSplitTestCase()
+    : TestCase("CSV split keeps quoted delimiters and escaped quotes")
+{
+}
+
+void
+CsvSplitTestCase::DoRun()
+{
+    std::vector<std::string> values = NetworkGymWifiScenario::CsvSplit("bursty,-82,16,20,36", ',');
+    NS_TEST_ASSERT_MSG_EQ(values.size(), 5, "unexpected number of fields");
+    NS_TEST_ASSERT_MSG_EQ(values[0], "bursty", "wrong first field");
+    NS_TEST_ASSERT_MSG_EQ(values[4], "36", "wrong last field");
+
+    values = NetworkGymWifiScenario::CsvSplit(R"("a,b","x""y",z)", ',');
+    NS_TEST_ASSERT_MSG_EQ(values.size(), 3, "quoted delimiter split the field");
+    NS_TEST_ASSERT_MSG_EQ(values[0], "a,b", "wrong quoted field");
+    NS_TEST_ASSERT_MSG_EQ(values[1], "x\"y", "wrong field with an escaped quote");
+    NS_TEST_ASSERT_MSG_EQ(values[2], "z", "wrong last field");
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Test the text and binary forms of the scenario configuration
+ */
+class NodeConfigTestCase : public TestCase
+{
+  public:
+    NodeConfigTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+NodeConfigTestCase::NodeConfigTestCase()
+    : TestCase("Node configuration parses the text form and round trips the binary form")
+{
+}
+
+void
+NodeConfigTestCase::DoRun()
+{
+    std::vector<NetworkGymNodeConfig> configs = NetworkGymNodeConfigLoader::ParseText(
+        "#NodeId:TrafficType,CcaSensitivity,TxPower,ChannelWidth,ChannelNumber\n"
+        "0:none,-82,12,80,42\n"
+        "\n"
+        "4:bursty,-72.5,16,20,36\r\n");
+    NS_TEST_ASSERT_MSG_EQ(configs.size(), 5, "the vector is indexed by node ID");
+    NS_TEST_ASSERT_MSG_EQ(configs[0].configured, true, "node 0 is configured");
+    NS_TEST_ASSERT_MSG_EQ(configs[1].configured, false, "node 1 is not configured");
+    NS_TEST_ASSERT_MSG_EQ(configs[0].channelWidth, 80, "wrong channel width");
+    NS_TEST_ASSERT_MSG_EQ(configs[4].trafficType, NETWORKGYM_TRAFFIC_BURSTY, "wrong traffic type");
+    NS_TEST_ASSERT_MSG_EQ(configs[4].ccaSensitivityDbm, -72.5, "wrong CCA sensitivity");
+    NS_TEST_ASSERT_MSG_EQ(configs[4].channelNumber, 36, "wrong channel number");
+
+    std::string filename = CreateTempDirFilename("networkgym-config.bin");
+    NetworkGymNodeConfigLoader::SaveBinary(filename, configs);
+    std::vector<NetworkGymNodeConfig> loaded = NetworkGymNodeConfigLoader::Load(filename);
+    NS_TEST_ASSERT_MSG_EQ(loaded.size(), configs.size(), "wrong number of nodes after the round trip");
+    NS_TEST_ASSERT_MSG_EQ(loaded[1].configured, false, "node 1 is not configured");
+    NS_TEST_ASSERT_MSG_EQ(loaded[4].trafficType, NETWORKGYM_TRAFFIC_BURSTY, "wrong traffic type");
+    NS_TEST_ASSERT_MSG_EQ(loaded[4].ccaSensitivityDbm, -72.5, "wrong CCA sensitivity");
+    NS_TEST_ASSERT_MSG_EQ(loaded[4].txPowerDbm, 16, "wrong TX power");
+    NS_TEST_ASSERT_MSG_EQ(loaded[0].channelNumber, 42, "wrong channel number");
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Test the histogram buckets and percentiles of the step phase timer
+ */
+class PhaseTimerTestCase : public TestCase
+{
+  public:
+    PhaseTimerTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+PhaseTimerTestCase::PhaseTimerTestCase()
+    : TestCase("Phase timer percentiles are within one bucket of the samples")
+{
+}
+
+void
+PhaseTimerTestCase::DoRun()
+{
+    for (uint64_t us : std::initializer_list<uint64_t>{0, 1, 15, 16, 17, 100, 1000, 123456, 1ULL << 40, UINT64_MAX})
+    {
+        uint64_t lower = PhaseTimer::GetBucketLowerBound(PhaseTimer::GetBucket(us));
+        NS_TEST_ASSERT_MSG_EQ((lower <= us), true, "the bucket of " << us << " starts above it");
+        NS_TEST_ASSERT_MSG_EQ((lower >= us - us / 8), true, "the bucket of " << us << " is too wide");
+    }
+
+    PhaseTimer timer;
+    for (uint64_t us = 1; us <= 100; us++)
+    {
+        timer.Record(PhaseTimer::SEND, us);
+    }
+    NS_TEST_ASSERT_MSG_EQ(timer.GetCount(PhaseTimer::SEND), 100, "wrong sample count");
+    NS_TEST_ASSERT_MSG_EQ(timer.GetPercentile(PhaseTimer::SEND, 0.5), 48, "wrong p50");
+    NS_TEST_ASSERT_MSG_EQ(timer.GetPercentile(PhaseTimer::SEND, 0.99), 96, "wrong p99");
+    NS_TEST_ASSERT_MSG_EQ(timer.GetPercentile(PhaseTimer::WAIT, 0.5), 0, "empty phase");
+
+    timer.AddBytes(PhaseTimer::MEASUREMENT_BYTES, 10);
+    timer.SetEnabled(true);
+    timer.AddBytes(PhaseTimer::MEASUREMENT_BYTES, 20);
+    json stats = timer.GetJson();
+    NS_TEST_ASSERT_MSG_EQ(stats["measurement_bytes"].get<uint64_t>(), 20, "bytes counted while disabled");
+    NS_TEST_ASSERT_MSG_EQ(stats["send"]["total_us"].get<uint64_t>(), 5050, "wrong total");
+    NS_TEST_ASSERT_MSG_EQ(stats.contains("wait"), false, "empty phases are not reported");
+}
+
+/**
+ * \ingroup networkgym-tests
+ * A policy that sets the TX power of every node to half of its measured TX power
+ */
+class HalfTxPowerPolicy : public InProcessPolicy
+{
+  public:
+    void GetAction(const json& networkStats, double ts, json& actionList) override
+    {
+        for (const auto& entry : networkStats)
+        {
+            if (entry["name"] != "Cpp2Py::TxPower")
+            {
+                continue;
+            }
+            std::vector<uint64_t> ids = entry["id"].get<std::vector<uint64_t>>();
+            std::vector<double> values = entry["value"].get<std::vector<double>>();
+            for (auto& value : values)
+            {
+                value /= 2;
+            }
+            actionList.push_back(MakeAction("Obss", "Py2Cpp::TxPowerNew", ts, ids, values));
+        }
+    }
+};
+
+/**
+ * \ingroup networkgym-tests
+ * Test that the action list of an in-process policy is accepted by the action dispatcher
+ */
+class InProcessPolicyTestCase : public TestCase
+{
+  public:
+    InProcessPolicyTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+InProcessPolicyTestCase::InProcessPolicyTestCase()
+    : TestCase("In-process policy actions are dispatched to the callbacks")
+{
+}
+
+void
+InProcessPolicyTestCase::DoRun()
+{
+    g_receivedActions.clear();
+    ActionDispatcher dispatcher;
+    for (uint64_t id : {2, 7})
+    {
+        dispatcher.Add("Obss::Py2Cpp::TxPowerNew", id, MakeBoundCallback(&RecvTestAction, id));
+    }
+
+    MeasurementAggregator aggregator;
+    uint32_t key = aggregator.Intern("Obss", "Cpp2Py::TxPower");
+    aggregator.Append(key, 300, 7, 20.0);
+    aggregator.Append(key, 300, 2, 16.0);
+    json networkStats = aggregator.Flush();
+
+    Ptr<InProcessPolicy> policy = CreateObject<HalfTxPowerPolicy>();
+    json actionList = json::array();
+    policy->GetAction(networkStats, 300, actionList);
+    NS_TEST_ASSERT_MSG_EQ(actionList.size(), 1, "unexpected number of action entries");
+    dispatcher.Dispatch(actionList, 300);
+    NS_TEST_ASSERT_MSG_EQ(g_receivedActions[2], 8.0, "wrong value for id 2");
+    NS_TEST_ASSERT_MSG_EQ(g_receivedActions[7], 10.0, "wrong value for id 7");
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Test the layout of the measurement record file
+ */
+class MeasurementRecorderTestCase : public TestCase
+{
+  public:
+    MeasurementRecorderTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+MeasurementRecorderTestCase::MeasurementRecorderTestCase()
+    : TestCase("Measurement recorder writes 8 byte aligned records")
+{
+}
+
+void
+MeasurementRecorderTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("networkgym-measurement.rec");
+    json networkStats = json::parse(R"([{"source":"Obss","name":"Cpp2Py::TxPower","ts":100,)"
+                                    R"("id":[0,1],"value":[15.0,20.0]}])");
+    MeasurementRecorder recorder;
+    recorder.Open(filename);
+    recorder.RecordStep(0, 100, networkStats);
+    recorder.RecordAction(1, 100, json::array());
+    recorder.Close();
+
+    std::ifstream file(filename, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    NS_TEST_ASSERT_MSG_EQ(data.size(), recorder.GetBytesWritten(), "queued records are not written");
+    NS_TEST_ASSERT_MSG_EQ(data.size() % 8, 0, "the records are not 8 byte aligned");
+    NS_TEST_ASSERT_MSG_EQ(data.substr(0, 7), "NGYMREC", "wrong magic");
+
+    // header, schema record (8 + 8 + 8 + 15 rounded up to 40), step record with 2 ids and values
+    // (8 + 24 + 24 + 16 + 16), action record (8 + 24 + "[]" rounded up to 32)
+    NS_TEST_ASSERT_MSG_EQ(data.size(), 16 + 40 + 88 + 40, "unexpected record sizes");
+    uint32_t type;
+    std::memcpy(&type, &data[16], sizeof type);
+    NS_TEST_ASSERT_MSG_EQ(type, MeasurementRecorder::SCHEMA, "the schema record is not first");
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Test that a replayed recording returns the recorded network stats and actions
+ */
+class MeasurementReplayTestCase : public TestCase
+{
+  public:
+    MeasurementReplayTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+MeasurementReplayTestCase::MeasurementReplayTestCase()
+    : TestCase("Measurement replay returns the recorded steps")
+{
+}
+
+void
+MeasurementReplayTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("networkgym-replay.rec");
+    json step0 = json::parse(R"([{"source":"Obss","name":"Cpp2Py::TxPower","ts":100,"id":[0,1],"value":[15.0,20.0]},)"
+                             R"({"source":"Obss","name":"Cpp2Py::Mcs","ts":100,"id":[0],"value":[[7,1]]}])");
+    json step1 = json::parse(R"([{"source":"Obss","name":"Cpp2Py::TxPower","ts":200,"id":[1],"value":[16.0]}])");
+    json action = json::parse(R"([{"source":"Obss","name":"Py2Cpp::TxPowerNew","ts":100,"id":[0],"value":[10.0]}])");
+    MeasurementRecorder recorder;
+    recorder.Open(filename);
+    recorder.RecordStep(0, 100, step0);
+    recorder.RecordAction(1, 100, action);
+    recorder.RecordAction(1, 100, json::array()); // a later step of the same exchange
+    recorder.RecordStep(1, 200, step1);
+    recorder.Close();
+
+    MeasurementReplay replay;
+    replay.Open(filename);
+    NS_TEST_ASSERT_MSG_EQ(replay.GetSteps().size(), 2, "unexpected number of steps");
+    NS_TEST_ASSERT_MSG_EQ(replay.GetSteps()[1].tsMs, 200, "wrong step ts");
+    NS_TEST_ASSERT_MSG_EQ((replay.GetNetworkStats(replay.GetSteps()[0]) == step0), true, "wrong network stats");
+    NS_TEST_ASSERT_MSG_EQ((replay.GetNetworkStats(replay.GetSteps()[1]) == step1), true, "wrong network stats");
+    NS_TEST_ASSERT_MSG_EQ((replay.GetAction(100) && *replay.GetAction(100) == action), true, "wrong action");
+    NS_TEST_ASSERT_MSG_EQ((replay.GetAction(200) == nullptr), true, "the last step has no action");
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Test that a parallel fill returns the rows in the order of a serial loop
+ */
+class WorkerPoolTestCase : public TestCase
+{
+  public:
+    WorkerPoolTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+WorkerPoolTestCase::WorkerPoolTestCase()
+    : TestCase("Worker pool merges the ranges in the row order")
+{
+}
+
+void
+WorkerPoolTestCase::DoRun()
+{
+    auto fn = [](uint32_t first, uint32_t last, NetworkGymWorkerPool::Builder& builder) {
+        for (uint32_t i = first; i < last; i++)
+        {
+            for (uint32_t j = 0; j < 3; j++)
+            {
+                builder.Append(i * 3 + j, i + 0.5 * j);
+            }
+        }
+    };
+    NetworkGymWorkerPool serial;
+    std::vector<uint64_t> serialIds;
+    std::vector<double> serialValues;
+    serial.Fill(1000, fn, serialIds, serialValues, 3);
+
+    NetworkGymWorkerPool pool;
+    pool.SetNThreads(4);
+    pool.SetGrainSize(8);
+    std::vector<uint64_t> ids;
+    std::vector<double> values;
+    for (uint32_t call = 0; call < 10; call++)
+    {
+        pool.Fill(1000, fn, ids, values, 3);
+        NS_TEST_ASSERT_MSG_EQ((ids == serialIds), true, "the ids differ from the serial loop");
+        NS_TEST_ASSERT_MSG_EQ((values == serialValues), true, "the values differ from the serial loop");
+    }
+    pool.Fill(2, fn, ids, values); // below the grain size, runs on the simulator thread
+    NS_TEST_ASSERT_MSG_EQ(ids.size(), 6, "unexpected size of a small fill");
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Test that the on-change reporting omits the unchanged values between keyframes
+ */
+class MeasurementDeltaTestCase : public TestCase
+{
+  public:
+    MeasurementDeltaTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+MeasurementDeltaTestCase::MeasurementDeltaTestCase()
+    : TestCase("Measurement delta omits the unchanged values")
+{
+}
+
+void
+MeasurementDeltaTestCase::DoRun()
+{
+    auto step = [](double x1, json ids) {
+        json networkStats = json::array();
+        networkStats.push_back({{"source", "Obss"}, {"name", "Cpp2Py::NodeX"}, {"ts", 100}, {"id", ids},
+                                {"value", json::array({1.0, x1, 3.0})}});
+        networkStats.push_back({{"source", "Obss"}, {"name", "Cpp2Py::Mcs"}, {"ts", 100}, {"id", {0}},
+                                {"value", {7}}});
+        return networkStats;
+    };
+    MeasurementDelta delta;
+    delta.Add("Obss::Cpp2Py::NodeX");
+    delta.SetKeyframeSteps(3);
+
+    json networkStats = step(2.0, {0, 1, 2});
+    delta.Encode(networkStats);
+    NS_TEST_ASSERT_MSG_EQ(networkStats[0]["delta"], false, "the first step is not a keyframe");
+    NS_TEST_ASSERT_MSG_EQ(networkStats[0]["id"].size(), 3, "the keyframe is not full");
+    NS_TEST_ASSERT_MSG_EQ(networkStats[1].contains("delta"), false, "a metric not reported on change has a delta flag");
+
+    networkStats = step(2.5, {0, 1, 2});
+    delta.Encode(networkStats);
+    NS_TEST_ASSERT_MSG_EQ(networkStats[0]["delta"], true, "the second step is not a delta");
+    NS_TEST_ASSERT_MSG_EQ((networkStats[0]["id"] == json::array({1})), true, "wrong changed ids");
+    NS_TEST_ASSERT_MSG_EQ((networkStats[0]["value"] == json::array({2.5})), true, "wrong changed values");
+
+    networkStats = step(2.5, {0, 1, 3});
+    delta.Encode(networkStats);
+    NS_TEST_ASSERT_MSG_EQ(networkStats[0]["delta"], false, "a removed id is not sent in full");
+
+    networkStats = step(2.5, {0, 1, 3});
+    delta.Encode(networkStats);
+    NS_TEST_ASSERT_MSG_EQ(networkStats[0]["delta"], false, "no keyframe after three steps");
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        networkStats = step(2.5, {0, 1, 3});
+        delta.Encode(networkStats);
+        NS_TEST_ASSERT_MSG_EQ(networkStats[0]["delta"], true, "a keyframe before the keyframe interval");
+        NS_TEST_ASSERT_MSG_EQ(networkStats[0]["id"].size(), 0, "unchanged values are sent");
+    }
+    NS_TEST_ASSERT_MSG_EQ(delta.GetOmittedValues(), 8, "wrong number of omitted values");
+
+    networkStats = step(2.5, {0, 1, 3});
+    delta.Encode(networkStats);
+    NS_TEST_ASSERT_MSG_EQ(networkStats[0]["delta"], false, "no keyframe after the keyframe interval");
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Test that the binary frame written from the merged columns and from the json decodes to the same columns
+ */
+class MeasurementEncoderTestCase : public TestCase
+{
+  public:
+    MeasurementEncoderTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+MeasurementEncoderTestCase::MeasurementEncoderTestCase()
+    : TestCase("Measurement encoder writes msgpack and cbor columns")
+{
+}
+
+void
+MeasurementEncoderTestCase::DoRun()
+{
+    MeasurementAggregator batch;
+    uint32_t x = batch.Intern("Obss", "Cpp2Py::NodeX");
+    uint32_t mcs = batch.Intern("Obss", "Cpp2Py::Mcs");
+    for (bool cbor : {false, true})
+    {
+        MeasurementEncoder encoder;
+        encoder.SetCbor(cbor);
+        auto decode = [cbor](const std::string& out) {
+            return cbor ? json::from_cbor(out) : json::from_msgpack(out);
+        };
+
+        std::vector<uint64_t> ids{2, 1};
+        std::vector<double> values{2.5, 1.5};
+        batch.Append(x, 100, ids, values);
+        batch.Append(mcs, 100, 300, json(7));
+        json schema = json::array();
+        std::string out;
+        encoder.Encode(batch, schema, out);
+        batch.Clear();
+
+        NS_TEST_ASSERT_MSG_EQ(schema.size(), 2, "both schema ids should be announced");
+        NS_TEST_ASSERT_MSG_EQ(schema[0]["name"], "Cpp2Py::NodeX", "wrong name of schema id 0");
+        json columns = decode(out);
+        NS_TEST_ASSERT_MSG_EQ(columns.size(), 2, "one column per key");
+        NS_TEST_ASSERT_MSG_EQ(columns[0][0], 0, "wrong schema id");
+        NS_TEST_ASSERT_MSG_EQ(columns[0][1], 100, "wrong ts");
+        NS_TEST_ASSERT_MSG_EQ((columns[0][2] == json::array({1, 2})), true, "the ids are not sorted");
+        const auto& packed = columns[0][3].get_binary();
+        NS_TEST_ASSERT_MSG_EQ(packed.size(), 2 * sizeof(double), "the doubles are not packed");
+        double first = 0;
+        std::memcpy(&first, packed.data(), sizeof(double));
+        NS_TEST_ASSERT_MSG_EQ(first, 1.5, "the values are not sorted with the ids");
+        NS_TEST_ASSERT_MSG_EQ((columns[1][2] == json::array({300})), true, "wrong id of a json column");
+        NS_TEST_ASSERT_MSG_EQ((columns[1][3] == json::array({7})), true, "wrong value of a json column");
+
+        // The json path shares the schema ids, and keeps the delta flag
+        json networkStats = json::array();
+        networkStats.push_back({{"source", "Obss"}, {"name", "Cpp2Py::NodeX"}, {"ts", 70000}, {"id", {70000}},
+                                {"value", json::array({0.5})}, {"delta", true}});
+        schema = json::array();
+        out.clear();
+        encoder.Encode(networkStats, schema, out);
+        NS_TEST_ASSERT_MSG_EQ(schema.empty(), true, "a schema id is announced twice");
+        columns = decode(out);
+        NS_TEST_ASSERT_MSG_EQ(columns[0].size(), 5, "the delta flag is missing");
+        NS_TEST_ASSERT_MSG_EQ(columns[0][0], 0, "the json path uses another schema id");
+        NS_TEST_ASSERT_MSG_EQ(columns[0][1], 70000, "wrong ts of the json path");
+        NS_TEST_ASSERT_MSG_EQ((columns[0][2] == json::array({70000})), true, "wrong ids of the json path");
+        NS_TEST_ASSERT_MSG_EQ(columns[0][3].get_binary().size(), sizeof(double), "the doubles are not packed");
+        NS_TEST_ASSERT_MSG_EQ(columns[0][4], true, "wrong delta flag");
+    }
+}
+
+/**
+ * \ingroup networkgym-tests
+ * A ZMQ ROUTER in a background thread, standing in for the networkgym server. Every measurement
+ * report of the southbound interface is passed to the handler, which returns the env-action msgs
+ * to reply with, possibly none or the held replies of earlier measurements.
+ */
+class LoopbackServer
+{
+  public:
+    /// The handler of a json measurement report, runs in the server thread
+    typedef std::function<std::vector<json>(const json& report)> Handler;
+
+    /**
+     * Bind the endpoint and start the server thread.
+     * \param endpoint the ZMQ endpoint, e.g., ipc:///tmp/networkgym-test/env.ipc
+     * \param handler the handler of the measurement reports
+     */
+    LoopbackServer(const std::string& endpoint, Handler handler)
+        : m_handler(handler)
+    {
+        m_context = zmq_ctx_new();
+        // The southbound interface uses PLAIN, the ZAP handler of the server thread accepts every user
+        m_zapSocket = zmq_socket(m_context, ZMQ_REP);
+        zmq_bind(m_zapSocket, "inproc://zeromq.zap.01");
+        m_socket = zmq_socket(m_context, ZMQ_ROUTER);
+        int one = 1;
+        zmq_setsockopt(m_socket, ZMQ_PLAIN_SERVER, &one, sizeof one);
+        // The forked episodes connect a new socket with the same identity
+        zmq_setsockopt(m_socket, ZMQ_ROUTER_HANDOVER, &one, sizeof one);
+        zmq_bind(m_socket, endpoint.c_str());
+        m_thread = std::thread(&LoopbackServer::Run, this);
+    }
+
+    ~LoopbackServer()
+    {
+        Stop();
+        zmq_close(m_socket);
+        zmq_close(m_zapSocket);
+        zmq_ctx_destroy(m_context);
+    }
+
+    /// Stop the server thread, the handler state can be read afterwards
+    void Stop()
+    {
+        m_running = false;
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+  private:
+    /**
+     * Receive all frames of a multipart msg.
+     * \param socket the socket
+     * \param frames the frames
+     */
+    static void ReceiveFrames(void* socket, std::vector<std::string>& frames)
+    {
+        frames.clear();
+        int more = 1;
+        while (more)
+        {
+            zmq_msg_t frame;
+            zmq_msg_init(&frame);
+            zmq_msg_recv(&frame, socket, 0);
+            frames.emplace_back(static_cast<const char*>(zmq_msg_data(&frame)), zmq_msg_size(&frame));
+            more = zmq_msg_more(&frame);
+            zmq_msg_close(&frame);
+        }
+    }
+
+    void Run()
+    {
+        std::vector<std::string> frames;
+        while (m_running)
+        {
+            zmq_pollitem_t items[] = {{m_socket, 0, ZMQ_POLLIN, 0}, {m_zapSocket, 0, ZMQ_POLLIN, 0}};
+            if (zmq_poll(items, 2, 10) <= 0)
+            {
+                continue;
+            }
+            if (items[1].revents & ZMQ_POLLIN)
+            {
+                // ZAP request: version, request id, domain, address, identity, mechanism, credentials
+                ReceiveFrames(m_zapSocket, frames);
+                std::vector<std::string> reply{"1.0", frames[1], "200", "OK", "", ""};
+                for (uint32_t i = 0; i < reply.size(); i++)
+                {
+                    zmq_send(m_zapSocket, reply[i].data(), reply[i].size(), i + 1 < reply.size() ? ZMQ_SNDMORE : 0);
+                }
+            }
+            if (!(items[0].revents & ZMQ_POLLIN))
+            {
+                continue;
+            }
+            // routing ID, client identity and the json report
+            ReceiveFrames(m_socket, frames);
+            if (frames.size() < 3)
+            {
+                continue;
+            }
+            for (const auto& action : m_handler(json::parse(frames[2])))
+            {
+                std::string msg = action.dump();
+                zmq_send(m_socket, frames[0].data(), frames[0].size(), ZMQ_SNDMORE);
+                zmq_send(m_socket, frames[1].data(), frames[1].size(), ZMQ_SNDMORE);
+                zmq_send(m_socket, msg.data(), msg.size(), 0);
+            }
+        }
+    }
+
+    Handler m_handler;
+    void* m_context;
+    void* m_socket;
+    void* m_zapSocket;
+    std::atomic<bool> m_running{true};
+    std::thread m_thread;
+};
+
+/**
+ * \ingroup networkgym-tests
+ * Write the env-configure.json and the gym-configure.json of a LoopbackServer into a new
+ * directory and enter it, the data processor and the southbound interface read them from the
+ * current directory.
+ * \param dir the directory
+ * \param envConfig the env-configure.json, the steps_per_episode, episodes_per_session and
+ *        subscribed_network_stats are required
+ * \return the endpoint of the LoopbackServer
+ */
+std::string
+EnterConfigDirectory(const std::string& dir, const json& envConfig)
+{
+    std::filesystem::create_directories(dir);
+    std::filesystem::current_path(dir);
+    json gymConfig;
+    gymConfig["env_identity"] = "networkgym-test";
+    gymConfig["client_identity"] = "networkgym-test-client";
+    gymConfig["session_name"] = "test";
+    gymConfig["session_key"] = "test";
+    gymConfig["env_port"] = 0;
+    // An ipc path is limited to about 100 characters, it is not placed in the test directory
+    std::string ipcPath = (std::filesystem::temp_directory_path() /
+                           ("networkgym-" + std::to_string(getpid()) + "-" +
+                            std::filesystem::path(dir).filename().string() + ".ipc"))
+                              .string();
+    gymConfig["env_transport"] = "ipc";
+    gymConfig["env_ipc_path"] = ipcPath;
+    std::ofstream("gym-configure.json") << gymConfig;
+    std::ofstream("env-configure.json") << envConfig;
+    return "ipc://" + ipcPath;
+}
+
+/**
+ * \ingroup networkgym-tests
+ * \param agent the agent group, or empty without agent groups
+ * \param ts the ts of the measurement
+ * \param id the node id
+ * \param value the action value
+ * \return an env-action msg with one Test::Py2Cpp::Action entry
+ */
+json
+MakeTestAction(const std::string& agent, uint64_t ts, uint64_t id, double value)
+{
+    json action;
+    action["type"] = "env-action";
+    if (!agent.empty())
+    {
+        action["agent"] = agent;
+    }
+    action["action_list"] = json::array(
+        {{{"source", "Test"}, {"name", "Py2Cpp::Action"}, {"ts", ts}, {"id", id}, {"value", value}}});
+    return action;
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Test that a slow agent group only delays its own measurements and actions
+ */
+class AgentGroupsTestCase : public TestCase
+{
+  public:
+    AgentGroupsTestCase();
+
+  private:
+    void DoRun() override;
+    /// Append the measurement of node 0 and node 1 and schedule the next step
+    void Measure(Ptr<DataProcessor> dataProcessor, uint32_t step);
+    /// Record the sim time an action of the node is applied at
+    void RecvAction(uint64_t id, const json& value);
+
+    static constexpr uint32_t STEPS = 8; //!< the steps of the session
+    std::vector<std::pair<double, int64_t>> m_actions[2]; //!< per node, action value and sim time in ms
+};
+
+AgentGroupsTestCase::AgentGroupsTestCase()
+    : TestCase("Agent groups exchange at their own speed")
+{
+}
+
+void
+AgentGroupsTestCase::Measure(Ptr<DataProcessor> dataProcessor, uint32_t step)
+{
+    Ptr<NetworkStats> stats = CreateObject<NetworkStats>("Test", 0, Simulator::Now().GetMilliSeconds());
+    std::vector<uint64_t> ids{0, 1};
+    std::vector<double> values{1.0 * step, 1.0 * step};
+    stats->Append("Cpp2Py::X", ids, values);
+    dataProcessor->AppendMeasurement(stats);
+    if (step + 1 < STEPS)
+    {
+        Simulator::Schedule(MilliSeconds(10), &AgentGroupsTestCase::Measure, this, dataProcessor, step + 1);
+    }
+}
+
+void
+AgentGroupsTestCase::RecvAction(uint64_t id, const json& value)
+{
+    m_actions[id].emplace_back(value.get<double>(), Simulator::Now().GetMilliSeconds());
+}
+
+void
+AgentGroupsTestCase::DoRun()
+{
+    json envConfig;
+    envConfig["steps_per_episode"] = STEPS;
+    envConfig["episodes_per_session"] = 1;
+    envConfig["subscribed_network_stats"] = {"Test::Cpp2Py::X"};
+    envConfig["agent_groups"] = {{{"name", "fast"}, {"id_range", {0, 0}}},
+                                 {{"name", "slow"}, {"id_range", {1, 1}}}};
+    auto cwd = std::filesystem::current_path();
+    std::string endpoint = EnterConfigDirectory(CreateTempDirFilename("agent-groups"), envConfig);
+
+    // The fast agent replies right away. The slow agent replies to its measurement k only after
+    // fast measurement k + 3, which is only sent if the fast group does not wait for the slow
+    // agent, a shared wait times out. The last measurement of a group does not have an action.
+    uint32_t fastCount = 0;
+    uint32_t slowCount = 0;
+    uint32_t slowReplied = 0;
+    uint32_t maxSlowInFlight = 0;
+    uint64_t maxSlowQueued = 0;
+    std::vector<json> heldReplies;
+    LoopbackServer server(endpoint, [&](const json& report) {
+        std::vector<json> replies;
+        uint64_t ts = report["network_stats"][0]["ts"].get<uint64_t>();
+        uint64_t queued = report["workload_stats"]["queued_measurements"].get<uint64_t>();
+        if (report["agent"] == "fast")
+        {
+            fastCount++;
+            if (fastCount < STEPS)
+            {
+                replies.push_back(MakeTestAction("fast", ts, 0, fastCount));
+            }
+        }
+        else
+        {
+            slowCount++;
+            maxSlowQueued = std::max(maxSlowQueued, queued);
+            maxSlowInFlight = std::max(maxSlowInFlight, slowCount - slowReplied);
+            if (slowCount < STEPS)
+            {
+                heldReplies.push_back(MakeTestAction("slow", ts, 1, slowCount));
+            }
+        }
+        while (slowReplied < heldReplies.size() && (fastCount >= slowReplied + 4 || fastCount == STEPS))
+        {
+            replies.push_back(heldReplies[slowReplied++]);
+        }
+        return replies;
+    });
+
+    Ptr<DataProcessor> dataProcessor = CreateObject<DataProcessor>();
+    dataProcessor->SetMaxPollTime(10000);
+    for (uint64_t id : {0, 1})
+    {
+        dataProcessor->SetNetworkGymActionCallback(
+            "Test::Py2Cpp::Action",
+            id,
+            MakeCallback(&AgentGroupsTestCase::RecvAction, this).Bind(id));
+    }
+    dataProcessor->StartMeasurement();
+    Simulator::ScheduleNow(&AgentGroupsTestCase::Measure, this, dataProcessor, 0);
+    Simulator::Run();
+    dataProcessor->Dispose();
+    Simulator::Destroy();
+    server.Stop();
+    std::filesystem::current_path(cwd);
+
+    NS_TEST_ASSERT_MSG_EQ(fastCount, STEPS, "the fast group did not send every measurement");
+    NS_TEST_ASSERT_MSG_EQ(slowCount, STEPS, "the slow group did not send every measurement");
+    NS_TEST_ASSERT_MSG_EQ(maxSlowInFlight, 1, "the slow group sent past its pending action");
+    NS_TEST_ASSERT_MSG_GT(maxSlowQueued, 0, "the slow group did not queue its measurements");
+    NS_TEST_ASSERT_MSG_EQ(m_actions[0].size(), STEPS - 1, "missing actions of the fast group");
+    NS_TEST_ASSERT_MSG_EQ(m_actions[1].size(), STEPS - 1, "missing actions of the slow group");
+    for (uint32_t k = 0; k < m_actions[1].size(); k++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_actions[1][k].first, k + 1, "the slow actions are out of order");
+    }
+    // reply 1 is released by fast measurement 4 at 30 ms and received at the next step at the earliest
+    NS_TEST_ASSERT_MSG_GT(m_actions[1][0].second, 30, "the slow action was not applied late");
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Test that the json measurement report parses back into the sent stats
+ */
+class SouthboundJsonTestCase : public TestCase
+{
+  public:
+    SouthboundJsonTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+SouthboundJsonTestCase::SouthboundJsonTestCase()
+    : TestCase("Southbound json measurement round trip")
+{
+}
+
+void
+SouthboundJsonTestCase::DoRun()
+{
+    auto cwd = std::filesystem::current_path();
+    std::string endpoint = EnterConfigDirectory(CreateTempDirFilename("southbound-json"), json::object());
+    std::mutex mutex;
+    std::vector<json> reports;
+    LoopbackServer server(endpoint, [&](const json& report) {
+        std::lock_guard<std::mutex> lock(mutex);
+        reports.push_back(report);
+        return std::vector<json>();
+    });
+
+    json networkStats = json::array(
+        {{{"source", "Test"}, {"name", "X"}, {"ts", 10}, {"id", {0, 1}}, {"value", {1.5, -2.25}}},
+         {{"source", "Test"}, {"name", "Y"}, {"ts", 10}, {"id", {1}}, {"value", {{{"a", "b"}, 3}}}}});
+    json workloadStats = {{"sim_time_ms", 10}};
+    json expectedStats = networkStats;
+    json expectedWorkloadStats = workloadStats;
+
+    Ptr<SouthboundInterface> southbound = CreateObject<SouthboundInterface>();
+    southbound->Connect();
+    southbound->SendMeasurementJson(networkStats, workloadStats);
+    // the second report reuses the pooled buffer of the first one
+    json agentStats = expectedStats;
+    json agentWorkloadStats = expectedWorkloadStats;
+    southbound->SendMeasurementJson(agentStats, agentWorkloadStats, "fast");
+    json emptyStats = json::array();
+    southbound->SendMeasurementJson(emptyStats);
+
+    for (uint32_t i = 0; i < 500; i++)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (reports.size() == 3)
+            {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    southbound->Dispose();
+    server.Stop();
+    std::filesystem::current_path(cwd);
+
+    NS_TEST_ASSERT_MSG_EQ(reports.size(), 3, "missing measurement reports");
+    for (const auto& report : reports)
+    {
+        NS_TEST_ASSERT_MSG_EQ(report["type"], "env-measurement", "wrong msg type");
+    }
+    NS_TEST_ASSERT_MSG_EQ(reports[0]["network_stats"], expectedStats, "wrong network stats");
+    NS_TEST_ASSERT_MSG_EQ(reports[0]["workload_stats"], expectedWorkloadStats, "wrong workload stats");
+    NS_TEST_ASSERT_MSG_EQ(reports[0].contains("agent"), false, "unexpected agent");
+    NS_TEST_ASSERT_MSG_EQ(reports[1]["network_stats"], expectedStats, "wrong network stats of the agent");
+    NS_TEST_ASSERT_MSG_EQ(reports[1]["workload_stats"], expectedWorkloadStats, "wrong workload stats of the agent");
+    NS_TEST_ASSERT_MSG_EQ(reports[1]["agent"], "fast", "wrong agent");
+    NS_TEST_ASSERT_MSG_EQ(reports[2]["network_stats"], json::array(), "wrong empty network stats");
+    NS_TEST_ASSERT_MSG_EQ(reports[2].contains("workload_stats"), false, "unexpected workload stats");
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Test the steps_per_exchange, action_lag_steps and fork_episodes modes of the DataProcessor
+ * against a loopback server, by the sim time each action is applied at
+ */
+class DataProcessorModesTestCase : public TestCase
+{
+  public:
+    DataProcessorModesTestCase();
+
+  private:
+    void DoRun() override;
+    /// steps_per_exchange with one action list per step of the next exchange
+    void RunStepsPerExchange();
+    /// the action of a measurement is applied one step later
+    void RunActionLag();
+    /// every episode runs in a forked child, which receives the reset action of its last measurement
+    void RunForkEpisodes();
+    /**
+     * Run a session of the measurements of node 0 every 10 ms.
+     * \param steps the measurements to schedule
+     */
+    void RunSession(uint32_t steps);
+    /// Append the measurement of node 0 and schedule the next step
+    void Measure(Ptr<DataProcessor> dataProcessor, uint32_t step, uint32_t steps);
+    /// Record the sim time an action is applied at
+    void RecvAction(const json& value);
+
+    std::vector<std::pair<double, int64_t>> m_actions; //!< action value and sim time in ms
+};
+
+DataProcessorModesTestCase::DataProcessorModesTestCase()
+    : TestCase("DataProcessor batched, pipelined and forked episode modes")
+{
+}
+
+void
+DataProcessorModesTestCase::Measure(Ptr<DataProcessor> dataProcessor, uint32_t step, uint32_t steps)
+{
+    Ptr<NetworkStats> stats = CreateObject<NetworkStats>("Test", 0, Simulator::Now().GetMilliSeconds());
+    stats->Append("Cpp2Py::X", 1.0 * step);
+    dataProcessor->AppendMeasurement(stats);
+    if (step + 1 < steps)
+    {
+        Simulator::Schedule(MilliSeconds(10),
+                            &DataProcessorModesTestCase::Measure,
+                            this,
+                            dataProcessor,
+                            step + 1,
+                            steps);
+    }
+}
+
+void
+DataProcessorModesTestCase::RecvAction(const json& value)
+{
+    m_actions.emplace_back(value.get<double>(), Simulator::Now().GetMilliSeconds());
+}
+
+void
+DataProcessorModesTestCase::RunSession(uint32_t steps)
+{
+    m_actions.clear();
+    Ptr<DataProcessor> dataProcessor = CreateObject<DataProcessor>();
+    dataProcessor->SetMaxPollTime(10000);
+    dataProcessor->SetNetworkGymActionCallback(
+        "Test::Py2Cpp::Action",
+        0,
+        MakeCallback(&DataProcessorModesTestCase::RecvAction, this));
+    dataProcessor->StartMeasurement();
+    Simulator::ScheduleNow(&DataProcessorModesTestCase::Measure, this, dataProcessor, 0, steps);
+    Simulator::Run();
+    dataProcessor->Dispose();
+    Simulator::Destroy();
+}
+
+void
+DataProcessorModesTestCase::RunStepsPerExchange()
+{
+    json envConfig;
+    envConfig["steps_per_episode"] = 6;
+    envConfig["episodes_per_session"] = 1;
+    envConfig["steps_per_exchange"] = 3;
+    envConfig["subscribed_network_stats"] = {"Test::Cpp2Py::X"};
+    auto cwd = std::filesystem::current_path();
+    std::string endpoint = EnterConfigDirectory(CreateTempDirFilename("steps-per-exchange"), envConfig);
+
+    std::vector<json> reports;
+    LoopbackServer server(endpoint, [&](const json& report) {
+        reports.push_back(report);
+        if (reports.size() == 2)
+        {
+            return std::vector<json>(); // the last measurement does not have an action
+        }
+        // one action list per step of the next exchange, with the ts of the last measurement
+        uint64_t ts = report["network_stats"].back()["ts"].get<uint64_t>();
+        json action = MakeTestAction("", ts, 0, 1);
+        json actionSteps = json::array();
+        for (double value : {1.0, 2.0, 3.0})
+        {
+            json step = action["action_list"];
+            step[0]["value"] = value;
+            actionSteps.push_back(step);
+        }
+        action["action_steps"] = actionSteps;
+        return std::vector<json>{action};
+    });
+    RunSession(6);
+    server.Stop();
+    std::filesystem::current_path(cwd);
+
+    NS_TEST_ASSERT_MSG_EQ(reports.size(), 2, "the 6 steps should be sent in 2 exchanges");
+    for (const auto& report : reports)
+    {
+        NS_TEST_ASSERT_MSG_EQ(report["network_stats"].size(), 3, "an exchange should carry an entry per step");
+        NS_TEST_ASSERT_MSG_EQ(report["workload_stats"]["exchange_steps"], 3, "wrong exchange_steps");
+    }
+    NS_TEST_ASSERT_MSG_EQ(reports[1]["network_stats"][0]["ts"], 30, "the entries should keep the ts of their step");
+    // the exchange at 20 ms is replied to, its action steps are applied at 20, 30 and 40 ms
+    NS_TEST_ASSERT_MSG_EQ(m_actions.size(), 3, "missing action steps");
+    for (uint32_t k = 0; k < m_actions.size(); k++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_actions[k].first, k + 1, "the action steps are out of order");
+        NS_TEST_ASSERT_MSG_EQ(m_actions[k].second, 20 + 10 * k, "the action step was applied at the wrong step");
+    }
+}
+
+void
+DataProcessorModesTestCase::RunActionLag()
+{
+    json envConfig;
+    envConfig["steps_per_episode"] = 6;
+    envConfig["episodes_per_session"] = 1;
+    envConfig["action_lag_steps"] = 1;
+    envConfig["subscribed_network_stats"] = {"Test::Cpp2Py::X"};
+    auto cwd = std::filesystem::current_path();
+    std::string endpoint = EnterConfigDirectory(CreateTempDirFilename("action-lag"), envConfig);
+
+    uint32_t count = 0;
+    LoopbackServer server(endpoint, [&](const json& report) {
+        count++;
+        if (count == 6)
+        {
+            return std::vector<json>();
+        }
+        uint64_t ts = report["network_stats"][0]["ts"].get<uint64_t>();
+        return std::vector<json>{MakeTestAction("", ts, 0, ts / 10)};
+    });
+    RunSession(6);
+    server.Stop();
+    std::filesystem::current_path(cwd);
+
+    NS_TEST_ASSERT_MSG_EQ(count, 6, "missing measurements");
+    // the action of measurement k is applied when measurement k + 1 is sent, the last one at the session end
+    NS_TEST_ASSERT_MSG_EQ(m_actions.size(), 5, "missing actions");
+    for (uint32_t k = 0; k < m_actions.size(); k++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_actions[k].first, k, "the actions are out of order");
+        NS_TEST_ASSERT_MSG_EQ(m_actions[k].second, 10 * (k + 1), "the action was not applied one step later");
+    }
+}
+
+void
+DataProcessorModesTestCase::RunForkEpisodes()
+{
+    json envConfig;
+    envConfig["steps_per_episode"] = 3;
+    envConfig["episodes_per_session"] = 2;
+    envConfig["fork_episodes"] = true;
+    envConfig["subscribed_network_stats"] = {"Test::Cpp2Py::X"};
+    auto cwd = std::filesystem::current_path();
+    std::string endpoint = EnterConfigDirectory(CreateTempDirFilename("fork-episodes"), envConfig);
+
+    std::vector<uint64_t> ts;
+    LoopbackServer server(endpoint, [&](const json& report) {
+        ts.push_back(report["network_stats"][0]["ts"].get<uint64_t>());
+        if (ts.size() == 6)
+        {
+            return std::vector<json>();
+        }
+        // the reply to the last measurement of the first episode is the reset action
+        return std::vector<json>{MakeTestAction("", ts.back(), 0, ts.size())};
+    });
+    pid_t parent = getpid();
+    RunSession(6);
+    if (getpid() != parent)
+    {
+        // a forked episode, the first one receives the action of every measurement including the
+        // reset, the last one has no action for its last measurement
+        std::vector<std::pair<double, int64_t>> firstEpisode{{1, 0}, {2, 10}, {3, 20}};
+        std::vector<std::pair<double, int64_t>> lastEpisode{{4, 0}, {5, 10}};
+        _exit(m_actions == firstEpisode || m_actions == lastEpisode ? 0 : 1);
+    }
+    server.Stop();
+    std::filesystem::current_path(cwd);
+
+    // the parent only returns after both children exited with 0, it never connects
+    NS_TEST_ASSERT_MSG_EQ(m_actions.size(), 0, "the parent should not exchange");
+    NS_TEST_ASSERT_MSG_EQ((ts == std::vector<uint64_t>{0, 10, 20, 0, 10, 20}),
+                          true,
+                          "every episode should start from the fork point");
+}
+
+void
+DataProcessorModesTestCase::DoRun()
+{
+    RunStepsPerExchange();
+    RunActionLag();
+    RunForkEpisodes();
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Test that the grid layout places every BSS in its own box
+ */
+class GridMobilityTestCase : public TestCase
+{
+  public:
+    GridMobilityTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+GridMobilityTestCase::GridMobilityTestCase()
+    : TestCase("Grid layout places the nodes in the box of their BSS")
+{
+}
+
+void
+GridMobilityTestCase::DoRun()
+{
+    // 5 BSSs on a 3 x 2 grid of 10 m boxes
+    NetworkGymWifiScenario scenario;
+    scenario.CreateNodes(5, 20);
+    scenario.InstallGridMobility(10, 1);
+
+    const NodeContainer& wifiNodes = scenario.GetWifiNodes();
+    for (uint32_t i = 0; i < wifiNodes.GetN(); i++)
+    {
+        uint32_t bss = scenario.GetBss(wifiNodes.Get(i)->GetId());
+        Vector position = wifiNodes.Get(i)->GetObject<MobilityModel>()->GetPosition();
+        NS_TEST_ASSERT_MSG_EQ((position.x >= (bss % 3) * 10.0 && position.x <= (bss % 3 + 1) * 10.0),
+                              true,
+                              "node " << i << " is outside the box of BSS " << bss);
+        NS_TEST_ASSERT_MSG_EQ((position.y >= (bss / 3) * 10.0 && position.y <= (bss / 3 + 1) * 10.0),
+                              true,
+                              "node " << i << " is outside the box of BSS " << bss);
+    }
+    Vector ap4 = scenario.GetApNodes().Get(4)->GetObject<MobilityModel>()->GetPosition();
+    NS_TEST_ASSERT_MSG_EQ_TOL(ap4.x, 15, 1e-9, "AP 4 is not at the center of its box");
+    NS_TEST_ASSERT_MSG_EQ_TOL(ap4.y, 15, 1e-9, "AP 4 is not at the center of its box");
+    NS_TEST_ASSERT_MSG_GT(NetworkGymWifiScenario::GetPeakRssKb(), 0, "the peak RSS is unknown");
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Test that the TGax RX power of the locations, computed on the worker threads, equals the
+ * RX power of the model
+ */
+class TgaxLocationTestCase : public TestCase
+{
+  public:
+    TgaxLocationTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+TgaxLocationTestCase::TgaxLocationTestCase()
+    : TestCase("TGax RX power of the locations equals the model")
+{
+}
+
+void
+TgaxLocationTestCase::DoRun()
+{
+    // 4 BSSs in 2 x 2 rooms, so the pairs cross 0 to 2 walls
+    NetworkGymWifiScenario scenario;
+    scenario.CreateNodes(4, 12);
+    scenario.InstallGridMobility(10, 1);
+
+    const NodeContainer& wifiNodes = scenario.GetWifiNodes();
+    const uint32_t n = wifiNodes.GetN();
+    auto lossModel = CreateObject<TgaxResidentialPropagationLossModel>();
+    std::vector<TgaxResidentialPropagationLossModel::Location> locations;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        locations.push_back(TgaxResidentialPropagationLossModel::GetLocation(
+            wifiNodes.Get(i)->GetObject<MobilityModel>()));
+    }
+
+    NetworkGymWorkerPool pool;
+    pool.SetNThreads(4);
+    pool.SetGrainSize(1);
+    std::vector<uint64_t> ids;
+    std::vector<double> values;
+    const TgaxResidentialPropagationLossModel* model = PeekPointer(lossModel);
+    pool.Fill(
+        n,
+        [n, model, &locations](uint32_t first, uint32_t last, NetworkGymWorkerPool::Builder& builder) {
+            for (uint32_t i = first; i < last; i++)
+            {
+                for (uint32_t j = 0; j < n; j++)
+                {
+                    builder.Append(i * n + j, model->CalcLocationRxPower(20, locations[i], locations[j]));
+                }
+            }
+        },
+        ids,
+        values,
+        n);
+
+    NS_TEST_ASSERT_MSG_EQ(values.size(), n * n, "unexpected number of pairs");
+    for (uint32_t i = 0; i < n; i++)
+    {
+        for (uint32_t j = 0; j < n; j++)
+        {
+            double expected = lossModel->CalcRxPower(20,
+                                                     wifiNodes.Get(i)->GetObject<MobilityModel>(),
+                                                     wifiNodes.Get(j)->GetObject<MobilityModel>());
+            NS_TEST_ASSERT_MSG_EQ_TOL(values[i * n + j], expected, 1e-9, "pair " << i << " -> " << j);
+        }
+    }
+    Simulator::Destroy();
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -80,6 +1505,23 @@ NetworkgymTestSuite::NetworkgymTestSuite()
 {
     // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
     AddTestCase(new NetworkgymTestCase1, TestCase::QUICK);
+    AddTestCase(new MeasurementAggregatorTestCase, TestCase::QUICK);
+    AddTestCase(new NetworkStatsTestCase, TestCase::QUICK);
+    AddTestCase(new ActionDispatcherTestCase, TestCase::QUICK);
+    AddTestCase(new CsvSplitTestCase, TestCase::QUICK);
+    AddTestCase(new NodeConfigTestCase, TestCase::QUICK);
+    AddTestCase(new PhaseTimerTestCase, TestCase::QUICK);
+    AddTestCase(new InProcessPolicyTestCase, TestCase::QUICK);
+    AddTestCase(new MeasurementRecorderTestCase, TestCase::QUICK);
+    AddTestCase(new MeasurementReplayTestCase, TestCase::QUICK);
+    AddTestCase(new WorkerPoolTestCase, TestCase::QUICK);
+    AddTestCase(new MeasurementDeltaTestCase, TestCase::QUICK);
+    AddTestCase(new MeasurementEncoderTestCase, TestCase::QUICK);
+    AddTestCase(new AgentGroupsTestCase, TestCase::QUICK);
+    AddTestCase(new SouthboundJsonTestCase, TestCase::QUICK);
+    AddTestCase(new DataProcessorModesTestCase, TestCase::QUICK);
+    AddTestCase(new GridMobilityTestCase, TestCase::QUICK);
+    AddTestCase(new TgaxLocationTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -1,5 +1,6 @@
 #include "ns3/core-module.h"
 #include "ns3/data-processor.h"
+#include "ns3/networkgym-replica-helper.h"
 #include "json.hpp"
 
 #include <chrono>
@@ -14,7 +15,7 @@ const unsigned seed = std::chrono::system_clock::now().time_since_epoch().count(
 std::mt19937 gen(seed);
 std::uniform_int_distribution<int> distrib(1, 10);
 // Data processor (south bound)
-auto dataProcessor = CreateObject<DataProcessor>();
+Ptr<DataProcessor> dataProcessor; // Created in main, after the replica working directory is set
 
 Time measStartTime;
 Time measInterval;
@@ -49,6 +50,14 @@ RecvAction(const json& action)
 int
 main(int argc, char* argv[])
 {
+    // With --replicaDirs=dir1,dir2,..., run one replica per directory in forked processes
+    int replicaExitCode = 0;
+    if (NetworkGymReplicaHelper::ForkReplicas(argc, argv, replicaExitCode))
+    {
+        return replicaExitCode;
+    }
+    dataProcessor = CreateObject<DataProcessor>();
+
     // Parse env config
     std::ifstream jsonStream("env-configure.json");
     json jsonConfig;
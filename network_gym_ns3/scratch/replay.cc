@@ -0,0 +1,46 @@
+// Replay the measurements recorded with "record_path" to the networkgym server, without a simulated network.
+// The env-configure.json sets "replay_path" to the recording, and optionally "replay_strict" to stop at the first
+// action that differs from the recorded one. The measurements keep their recorded ts. By default they are sent as
+// fast as the agent replies, with --realtime at the recorded step cadence.
+
+#include "ns3/core-module.h"
+#include "ns3/data-processor.h"
+
+#include <fstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("Replay");
+using json = nlohmann::json;
+
+int
+main(int argc, char* argv[])
+{
+    bool realtime = false; ///< Replay at the recorded cadence instead of as fast as possible
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("realtime", "Replay the steps at their recorded wall clock cadence", realtime);
+    cmd.Parse(argc, argv);
+
+    if (realtime)
+    {
+        GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::RealtimeSimulatorImpl"));
+    }
+
+    std::ifstream jsonStream("env-configure.json");
+    json jsonConfig;
+    jsonStream >> jsonConfig;
+    if (!jsonConfig.contains("replay_path"))
+    {
+        NS_FATAL_ERROR("The env-configure.json should set the replay_path to a measurement recording.");
+    }
+
+    Ptr<DataProcessor> dataProcessor = CreateObject<DataProcessor>();
+    dataProcessor->SetMaxPollTime(jsonConfig.value("max_wait_time_for_action_ms", 600000));
+    Simulator::ScheduleNow(&DataProcessor::StartMeasurement, dataProcessor);
+
+    Simulator::Run();
+    dataProcessor->Dispose();
+    Simulator::Destroy();
+    return 0;
+}
@@ -20,6 +20,7 @@
 #include "ns3/command-line.h"
 #include "ns3/config.h"
 #include "ns3/data-processor.h"
+#include "ns3/networkgym-replica-helper.h"
 #include "ns3/eht-configuration.h"
 #include "ns3/eht-phy.h"
 #include "ns3/frame-exchange-manager.h"
@@ -166,7 +167,7 @@ private:
 NS_OBJECT_ENSURE_REGISTERED(AiWifiManager);
 
 // Data processor (south bound)
-auto dataProcessor = CreateObject<DataProcessor>();
+Ptr<DataProcessor> dataProcessor; // Created in main, after the replica working directory is set
 
 Time measStartTime;
 Time measInterval;
@@ -251,6 +252,14 @@ RecvAction(const json& action)
 int
 main(int argc, char* argv[])
 {
+    // With --replicaDirs=dir1,dir2,..., run one replica per directory in forked processes
+    int replicaExitCode = 0;
+    if (NetworkGymReplicaHelper::ForkReplicas(argc, argv, replicaExitCode))
+    {
+        return replicaExitCode;
+    }
+    dataProcessor = CreateObject<DataProcessor>();
+
     double frequency{5}; // 2.4 / 5 / 6 GHz
     int mcs{1};    // Initial mcs
     int channelWidth{20};
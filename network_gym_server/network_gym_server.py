@@ -127,6 +127,9 @@ class ServerTask(threading.Thread):
         backend = context.socket(zmq.ROUTER)
         backend.plain_server = True  # must come before bind
         backend.bind('tcp://*:'+str(self.config_json["network_gym_sim_port"]))
+        if "network_gym_sim_ipc_path" in self.config_json:
+            # env workers on the same host may connect to a unix domain socket instead of the loopback tcp.
+            backend.bind('ipc://'+self.config_json["network_gym_sim_ipc_path"])
 
         #frontend connects to network gym clients.
         #backend connects to network gym env workers.
@@ -252,7 +255,7 @@ class ServerTask(threading.Thread):
                 elif relay_json["type"] == "env-measurement":
                     #measurement from network gym simlulation
                     print("Relay Measurement from: " + str(address)+ " to Algorithm Client: " + str(identity))
-                    frontend.send_multipart([identity, reply])#relay measurement to the algorithm
+                    frontend.send_multipart([identity] + msg[2:])#relay measurement to the algorithm, binary encoded network stats are carried in an extra frame
                     #influxdb = influxdb_thread(address.decode(), identity.decode(), relay_json, self.config_json["influxdb"])#save to influxdb in a new thread
                     #influxdb.start()
                     self.busy_workers_last_ts_dict[address] = current_time